@@ -0,0 +1,260 @@
+
+#include <cstdlib>
+
+#include "Advance/Util.hpp"
+#include "Advance/MemPool.hpp"
+#include "Advance/MemAccount.hpp"
+#include "Advance/Arena.hpp"
+
+namespace common {
+
+struct Arena::Block
+{
+	/** next block */
+	Block*	next = { NULL };
+	/** block length, including this */
+	size_t	length = { 0 };
+};
+
+struct Arena::Large
+{
+	/** next large */
+	Large*	next = { NULL };
+	/** keep data aligned */
+	size_t	pad = { 0 };
+};
+
+struct Arena::Cleanup
+{
+	/** next cleanup */
+	Cleanup* next = { NULL };
+	/** cleanup handle */
+	void	(*handle)(void*) = { NULL };
+	/** handle param */
+	void*	data = { NULL };
+};
+
+const size_t Arena::c_block_head = up_align(sizeof(Arena::Block), arena::c_align);
+
+/** arena block piece, thread magazine for request thread churn */
+static MemConfig&
+arena_config() {
+	static MemConfig s_config(arena::c_block_len, arena::c_align);
+	s_config.magazine = memory::c_magazine_len;
+	s_config.account = account::AT_arena;
+	return s_config;
+}
+
+BaseAlloter*
+arena_pool()
+{
+	static MemPool s_arena_pool(arena_config());
+	return &s_arena_pool;
+}
+
+Arena::Arena(BaseAlloter* alloter)
+	: m_alloter(alloter ? alloter : arena_pool())
+{
+	piece(m_alloter->piece());
+}
+
+void*
+Arena::_new(size_t len)
+{
+	len = up_align(std::max(len, (size_t)1), arena::c_align);
+	if (m_pos + len > m_end) {
+		/** large request not waste current block */
+		if (len > piece() / 4) {
+			return new_large(len);
+		}
+		if (!next_block(len)) {
+			return NULL;
+		}
+	}
+	void* data = m_pos;
+	m_pos += len;
+	m_used += len;
+	mem_account(m_account, len);
+	return data;
+}
+
+bool
+Arena::next_block(size_t len)
+{
+	void* data = m_alloter->_new(piece());
+	if (!data) {
+		return false;
+	}
+	Block* block = ::new(data) Block;
+	block->length = piece();
+	block->next = m_block;
+	m_block = block;
+	m_blocks++;
+
+	m_pos = (byte_t*)block + c_block_head;
+	m_end = (byte_t*)block + block->length;
+	return m_pos + len <= m_end;
+}
+
+void*
+Arena::new_large(size_t len)
+{
+	void* data = ::malloc(sizeof(Large) + len);
+	if (!data) {
+		return NULL;
+	}
+	Large* large = ::new(data) Large;
+	large->next = m_large;
+	m_large = large;
+	m_used += len;
+	mem_account(m_account, len);
+	return large + 1;
+}
+
+void
+Arena::cleanup(void (*handle)(void*), void* data)
+{
+	Cleanup* cleanup = (Cleanup*)_new(sizeof(Cleanup));
+	assert(cleanup != NULL);
+	cleanup->handle = handle;
+	cleanup->data = data;
+	cleanup->next = m_cleanup;
+	m_cleanup = cleanup;
+}
+
+void
+Arena::run_cleanup()
+{
+	/** cleanup list is in reverse order of create */
+	while (m_cleanup) {
+		Cleanup* cleanup = m_cleanup;
+		m_cleanup = cleanup->next;
+		cleanup->handle(cleanup->data);
+	}
+	while (m_large) {
+		Large* large = m_large;
+		m_large = large->next;
+		::free(large);
+	}
+}
+
+void
+Arena::reset()
+{
+	run_cleanup();
+	mem_account(m_account, -(int64_t)m_used);
+	m_used = 0;
+	if (!m_block) {
+		return;
+	}
+	/** keep the oldest block, most request fit in one block */
+	while (m_block->next) {
+		Block* block = m_block;
+		m_block = block->next;
+		m_alloter->_del(block);
+		m_blocks--;
+	}
+	m_pos = (byte_t*)m_block + c_block_head;
+	m_end = (byte_t*)m_block + m_block->length;
+}
+
+void
+Arena::clear()
+{
+	run_cleanup();
+	mem_account(m_account, -(int64_t)m_used);
+	while (m_block) {
+		Block* block = m_block;
+		m_block = block->next;
+		m_alloter->_del(block);
+	}
+	m_blocks = 0;
+	m_pos = m_end = NULL;
+	m_used = 0;
+}
+}
+
+#if COMMON_TEST
+#include <string>
+#include <cstring>
+
+#include "Common/LogHelper.hpp"
+#include "Common/Display.hpp"
+#include "Perform/Debug.hpp"
+#include "Perform/Timer.hpp"
+
+namespace common {
+namespace tester {
+
+	struct ArenaType
+	{
+		ArenaType(int* count) : m_count(count) { (*m_count)++; }
+		~ArenaType() { (*m_count)--; }
+
+		int*	m_count;
+		std::string m_name = { "arena type with long name, not in sso buffer" };
+	};
+
+	/**
+	 * request like alloc, dozens of small piece
+	 **/
+	template<class Handle>
+	void	__arena_request(Handle&& handle) {
+		for (int i = 0; i < 32; i++) {
+			void* data = handle(32 + (i % 8) * 48);
+			memset(data, i, 32);
+		}
+	}
+
+	void
+	arena_test()
+	{
+		Arena arena;
+		int count = 0;
+		for (int loop = 0; loop < 100; loop++) {
+			for (int i = 0; i < 1000; i++) {
+				size_t len = (i * 37) % 3000 + 1;
+				byte_t* data = (byte_t*)arena._new(len);
+				success(((uint64_t)data & (arena::c_align - 1)) == 0);
+				memset(data, i, len);
+			}
+			/** large one out of block */
+			memset(arena._new(arena::c_block_len * 2), 0, arena::c_block_len * 2);
+
+			for (int i = 0; i < 100; i++) {
+				ArenaType* type = arena.create<ArenaType>(&count);
+				success(type->m_name.length() > 0);
+			}
+			success(count == 100);
+			arena.reset();
+			success(count == 0 && arena.used() == 0 && arena.blocks() == 1);
+		}
+
+		const int64_t total = 100000;
+		do {
+			CREATE_TIMER;
+			for (int64_t i = 0; i < total; i++) {
+				void* array[32];
+				int index = 0;
+				__arena_request([&](size_t len) { return array[index++] = ::malloc(len); });
+				for (auto data : array) {
+					::free(data);
+				}
+			}
+			ctime_t time = timer.check();
+			log_info("arena request, malloc, " << string_iops(total, time) << " request/s");
+		} while (0);
+
+		do {
+			CREATE_TIMER;
+			for (int64_t i = 0; i < total; i++) {
+				__arena_request([&](size_t len) { return arena._new(len); });
+				arena.reset();
+			}
+			ctime_t time = timer.check();
+			log_info("arena request, arena,  " << string_iops(total, time) << " request/s");
+		} while (0);
+	}
+}
+}
+#endif
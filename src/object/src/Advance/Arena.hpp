@@ -0,0 +1,145 @@
+
+#pragma once
+
+#include <new>
+#include <utility>
+#include <type_traits>
+
+#include "Common/Const.hpp"
+#include "Common/Define.hpp"
+#include "Advance/BaseAlloter.hpp"
+
+namespace common {
+
+	namespace arena {
+		/** default block length, piece of arena block pool */
+		static const int c_block_len = 16 * c_length_1K;
+		/** bump align */
+		static const int c_align = 16;
+	}
+
+	/**
+	 * request scope alloter, bump alloc from pool piece, free all by reset
+	 *
+	 * @note not thread safe, _del do nothing; request larger than block use malloc
+	 **/
+	class Arena : public BaseAlloter
+	{
+	public:
+		/**
+		 * @param alloter block alloter, use arena block pool if null
+		 **/
+		Arena(BaseAlloter* alloter = NULL);
+
+		virtual ~Arena() { clear(); }
+
+	public:
+		/**
+		 * bump alloc len
+		 **/
+		virtual void* _new(size_t len = 0);
+
+		/**
+		 * memory kept until reset
+		 **/
+		virtual void  _del(void* data, size_t len = 0) {}
+
+		/**
+		 * run destructor, give back blocks except the first one
+		 **/
+		void	reset();
+
+		/**
+		 * run destructor, give back all blocks
+		 **/
+		void	clear();
+
+	public:
+		/**
+		 * construct type in arena, destructor called when reset
+		 **/
+		template<class Type, class...Args>
+		Type*	create(Args&&...args) {
+			void* data = _new(sizeof(Type));
+			if (!data) {
+				return NULL;
+			}
+			Type* type = ::new(data) Type(std::forward<Args>(args)...);
+			if (!std::is_trivially_destructible<Type>::value) {
+				cleanup(destroy<Type>, type);
+			}
+			return type;
+		}
+
+		/**
+		 * regist cleanup handle, called in reverse order when reset
+		 **/
+		void	cleanup(void (*handle)(void*), void* data);
+
+		/**
+		 * total alloc length since last reset
+		 **/
+		size_t	used() { return m_used; }
+
+		/**
+		 * block count
+		 **/
+		int		blocks() { return m_blocks; }
+
+	protected:
+		struct Block;
+		struct Large;
+		struct Cleanup;
+
+		/** block head length, keep data aligned */
+		static const size_t c_block_head;
+
+		/**
+		 * destruct type
+		 **/
+		template<class Type>
+		static void destroy(void* data) { ((Type*)data)->~Type(); }
+
+		/**
+		 * alloc new block for len
+		 **/
+		bool	next_block(size_t len);
+
+		/**
+		 * alloc out of block
+		 **/
+		void*	new_large(size_t len);
+
+		/**
+		 * run all cleanup handle
+		 **/
+		void	run_cleanup();
+
+	protected:
+		/** block alloter */
+		BaseAlloter* m_alloter = { NULL };
+		/** block list, current one at head */
+		Block*	m_block = { NULL };
+		/** large alloc list */
+		Large*	m_large = { NULL };
+		/** cleanup list */
+		Cleanup* m_cleanup = { NULL };
+		/** current bump position */
+		byte_t*	m_pos = { NULL };
+		/** current block end */
+		byte_t*	m_end = { NULL };
+		/** alloc length */
+		size_t	m_used = { 0 };
+		/** block count */
+		int		m_blocks = { 0 };
+	};
+
+	/**
+	 * get arena block pool
+	 **/
+	BaseAlloter* arena_pool();
+}
+
+#if COMMON_SPACE
+	using common::Arena;
+#endif
@@ -4,11 +4,79 @@
 
 #include "Common/TypeQueue.hpp"
 #include "Common/Container.hpp"
+#include "Common/Atomic.hpp"
 #include "Advance/Util.hpp"
+#include "Advance/MemAccount.hpp"
 #include "Advance/BaseAlloter.hpp"
 
 namespace common {
 
+/**
+ * remote free queue of batch alloter, other thread give piece back here
+ *
+ * @note mpsc, freeing thread push by cas, owner take all by swap when refill;
+ * 		 queue kept after owner exit, until all piece it owned come back
+ **/
+struct RemoteQueue
+{
+	/** piece list head, closed when owner exit */
+	volatile int64_t m_head = { 0 };
+	/** piece apply from origin alloter and not give back yet, one more held by owner until close */
+	volatile int64_t m_owned = { 1 };
+	/** origin alloter */
+	BaseAlloter* m_alloter = { NULL };
+};
+
+/**
+ * piece head in remote mode, before user data
+ **/
+struct RemoteHead
+{
+	/** owner queue */
+	RemoteQueue* owner;
+	/** link in remote queue */
+	RemoteHead*	next;
+};
+
+/** remote head length, keep user data aligned */
+static const size_t c_remote_head = 16;
+/** remote queue head when owner exit */
+static const int64_t c_remote_closed = 1;
+
+/**
+ * owned piece given back to origin alloter, delete queue if last one after closed
+ **/
+static void
+remote_put(RemoteQueue* queue, int64_t count)
+{
+	if (atomic_add64(&queue->m_owned, -count) == count &&
+		queue->m_head == c_remote_closed)
+	{
+		queue->m_alloter->cycle();
+		delete queue;
+	}
+}
+
+/**
+ * free piece to owner queue, give back to origin alloter if owner exit
+ **/
+static void
+remote_free(RemoteHead* head)
+{
+	RemoteQueue* queue = head->owner;
+	int64_t prev = queue->m_head;
+	while (prev != c_remote_closed) {
+		head->next = (RemoteHead*)prev;
+		int64_t last = atomic_comp_swap64(&queue->m_head, (int64_t)head, prev);
+		if (last == prev) {
+			return;
+		}
+		prev = last;
+	}
+	queue->m_alloter->_del(head);
+	remote_put(queue, 1);
+}
+
 /**
  * alloter for local thread
  **/
@@ -27,9 +95,9 @@ public:
 	/**
 	 * set local thread alloter config
 	 **/
-	void 		set(BaseAlloter* alloter, int type, uint32_t limit = 0, uint32_t batch = 0) {
+	void 		set(BaseAlloter* alloter, int type, uint32_t limit = 0, uint32_t batch = 0, bool remote = false) {
 		assert(type < c_max_size);
-		m_array[type].set(alloter, limit, batch);
+		m_array[type].set(alloter, limit, batch, remote);
 	}
 
 	/**
@@ -39,6 +107,13 @@ public:
 		return &m_array[type];
 	}
 
+	/**
+	 * check if local thread alloter in remote mode
+	 **/
+	bool		remote(int type) {
+		return m_array[type].remote();
+	}
+
 public:
 	class BatchAlloter : public BaseAlloter {
 	public:
@@ -49,27 +124,47 @@ public:
 		/**
 		 * set alloter status
 		 **/
-		void	set(BaseAlloter* alloter = NULL, uint32_t limit = 0, uint32_t batch = 0) {
+		void	set(BaseAlloter* alloter = NULL, uint32_t limit = 0, uint32_t batch = 0, bool remote = false) {
+			if (m_remote) {
+				release();
+				close();
+			}
 			m_alloter = alloter;
 			m_limit = (limit == 0 ? c_local_limit : limit);
 			m_batch = (batch == 0 ? c_local_batch : batch);
 
             if (m_alloter) {
 			    piece(m_alloter->piece());
+
+			    if (remote) {
+			    	assert(piece() > c_remote_head);
+			    	piece(piece() - c_remote_head);
+			    	m_remote = new RemoteQueue;
+			    	m_remote->m_alloter = m_alloter;
+			    }
             }
 		}
+
+		/**
+		 * check if in remote mode
+		 **/
+		bool	remote() { return m_remote != NULL; }
+
 		/**
 		 * @brief new for request len
 		 * @param len mem len
 		 */
 		virtual void* _new(size_t len = 0) {
 			if (m_list.size() == 0) {
-				/** alloc failed */
-				if (!apply_for(len)) {
+				/** take remote free first, alloc failed if still empty */
+				if (!drain() && !apply_for(len)) {
 					return NULL;
 				}
 			}
 			void* data = m_list.deque_back();
+			if (m_remote) {
+				data = (byte_t*)data + c_remote_head;
+			}
 			return data;
 		}
 
@@ -79,6 +174,15 @@ public:
 		 * @param len del len, unused most times
 		 */
 		virtual void  _del(void* data, size_t len = 0) {
+			if (m_remote) {
+				RemoteHead* head = (RemoteHead*)((byte_t*)data - c_remote_head);
+				/** piece of other thread, give back to owner */
+				if (head->owner != m_remote) {
+					remote_free(head);
+					return;
+				}
+				data = head;
+			}
 			m_list.enque(data);
 			put_back();
 		}
@@ -89,7 +193,12 @@ public:
 		virtual void cycle() {
             if (m_alloter) {
             	release();
-			    m_alloter->cycle();
+            	if (m_remote) {
+            		/** origin alloter cycled with queue, piece may still in other thread */
+            		close();
+            	} else {
+				    m_alloter->cycle();
+            	}
                 m_alloter = NULL;
             }
 		}
@@ -101,6 +210,9 @@ public:
 			for (auto data: m_list) {
 				m_alloter->_del(data);
 			}
+			if (m_remote) {
+				remote_put(m_remote, m_list.size());
+			}
 			m_list.clear();
 		}
 
@@ -109,16 +221,26 @@ public:
 		 * apply for more piece
 		 **/
 		bool 	apply_for(size_t len) {
-			int count = 0;
-			while (count++ < m_batch) {
+			if (m_remote && len > 0) {
+				len += c_remote_head;
+			}
+			int64_t count = 0;
+			while (count < m_batch) {
 				void* data = m_alloter->_new(len);
 				if (data) {
+					if (m_remote) {
+						((RemoteHead*)data)->owner = m_remote;
+					}
 					m_list.enque(data);
+					count++;
 				} else {
 					break;
 				}
 			}
-			return m_list.size() > 0;
+			if (m_remote && count > 0) {
+				atomic_add64(&m_remote->m_owned, count);
+			}
+			return count > 0;
 		}
 
 		/**
@@ -126,18 +248,60 @@ public:
 		 **/
 		void 	put_back() {
 			if ((int)m_list.size() > m_limit + m_batch) {
+				int64_t count = 0;
 				while ((int)m_list.size() > m_limit) {
 					void* data = m_list.deque_back();
 					m_alloter->_del(data);
+					count++;
+				}
+				if (m_remote) {
+					remote_put(m_remote, count);
 				}
 			}
 		}
 
+		/**
+		 * take all remote free piece in one swap
+		 **/
+		bool	drain() {
+			if (!m_remote || m_remote->m_head == 0) {
+				return false;
+			}
+			RemoteHead* head = (RemoteHead*)atomic_swap64(&m_remote->m_head, 0);
+			while (head) {
+				m_list.enque(head);
+				head = head->next;
+			}
+			return m_list.size() > 0;
+		}
+
+		/**
+		 * close remote queue when owner exit, later remote free go to origin alloter
+		 **/
+		void	close() {
+			RemoteHead* head = (RemoteHead*)atomic_swap64(&m_remote->m_head, c_remote_closed);
+			int64_t count = 0;
+			while (head) {
+				RemoteHead* next = head->next;
+				m_alloter->_del(head);
+				head = next;
+				count++;
+			}
+			if (count > 0) {
+				remote_put(m_remote, count);
+			}
+			/** owner refer dropped last, queue deleted by last piece given back, or now */
+			remote_put(m_remote, 1);
+			m_remote = NULL;
+		}
+
 	protected:
 		/** local keep piece */
 		TypeQueue<void*> m_list;
 		/** origin alloter */
 		BaseAlloter*	 m_alloter = { NULL };
+		/** remote free queue, null if not in remote mode */
+		RemoteQueue*	 m_remote = { NULL };
 	    int     m_limit = { 0 };
 		int 	m_batch = { 0 };
 	};
@@ -158,27 +322,33 @@ thread_local std::shared_ptr<ThreadAlloter> s_local;
 void*
 BaseAlloter::_new(size_t len)
 {
+	void* data = NULL;
 	if (m_align == 0) {
-		return ::malloc(up_align(piece(), c_malloc_unit));
+		data = ::malloc(up_align(piece(), c_malloc_unit));
 
 	} else {
-		return aligned_alloc(m_align, m_piece);
+		data = aligned_alloc(m_align, m_piece);
+	}
+	if (data) {
+		mem_account(m_account, m_piece);
 	}
+	return data;
 }
 
 void
 BaseAlloter::_del(void* data, size_t len)
 {
+	mem_account(m_account, -(int64_t)m_piece);
 	::free(data);
 }
 
 void
-LocalAlloter(BaseAlloter* alloter, int type, int limit, int batch)
+LocalAlloter(BaseAlloter* alloter, int type, int limit, int batch, bool remote)
 {
 	if (!s_local) {
 		s_local = std::make_shared<ThreadAlloter>();
 	}
-	s_local->set(alloter, type, limit, batch);
+	s_local->set(alloter, type, limit, batch, remote);
 }
 
 BaseAlloter*
@@ -186,12 +356,28 @@ LocalAlloter(int type)
 {
 	return s_local->get(type);
 }
+
+void
+LocalFree(int type, void* data)
+{
+	if (s_local && s_local->remote(type)) {
+		s_local->get(type)->_del(data);
+
+	} else {
+		remote_free((RemoteHead*)((byte_t*)data - c_remote_head));
+	}
+}
 }
 
 #if COMMON_TEST
 
+#include "Common/LogHelper.hpp"
+#include "Common/Mutex.hpp"
+#include "Common/Display.hpp"
+#include "Advance/MemPool.hpp"
 #include "Perform/TestUtil.hpp"
 #include "Perform/Debug.hpp"
+#include "Perform/Timer.hpp"
 using namespace common;
 
 namespace common {
@@ -211,6 +397,147 @@ namespace tester {
 		batchs(30, __local_alloter, &base, 0, 10, 5);
 		thread_wait();
 	}
+
+	/**
+	 * count piece not given back
+	 **/
+	class RemoteCount : public BaseAlloter
+	{
+	public:
+		RemoteCount(size_t len) : BaseAlloter(len) {}
+
+	public:
+		virtual void* _new(size_t len = 0) {
+			at_inc64(m_count);
+			return BaseAlloter::_new(len);
+		}
+
+		virtual void  _del(void* data, size_t len = 0) {
+			at_dec64(m_count);
+			BaseAlloter::_del(data, len);
+		}
+
+	public:
+		volatile int64_t m_count = { 0 };
+	};
+
+	/**
+	 * piece pass from producer to consumer
+	 **/
+	struct RemoteChannel
+	{
+		Mutex	m_mutex = { "remote channel" };
+		TypeQueue<void*> m_list;
+		volatile bool m_done = { false };
+	};
+
+	void
+	__remote_producer(BaseAlloter* alloter, RemoteChannel* channel, int64_t count, bool remote, bool check)
+	{
+		const int batch = 64;
+		LocalAlloter(alloter, 0, 0, 0, remote);
+		BaseAlloter* local = LocalAlloter(0);
+
+		for (int64_t i = 0; i < count; i += batch) {
+			void* array[batch];
+			for (int j = 0; j < batch; j++) {
+				array[j] = local->_new();
+				if (check) {
+					*(int64_t*)array[j] = i + j;
+				}
+			}
+			Mutex::Locker lock(channel->m_mutex);
+			for (auto data : array) {
+				channel->m_list.enque(data);
+			}
+		}
+		channel->m_done = true;
+	}
+
+	void
+	__remote_consumer(BaseAlloter* alloter, RemoteChannel* channel, bool remote, bool check)
+	{
+		if (!remote) {
+			LocalAlloter(alloter, 0);
+		}
+		int64_t next = 0;
+		while (true) {
+			bool done = channel->m_done;
+			void* array[64];
+			int size = 0;
+			do {
+				Mutex::Locker lock(channel->m_mutex);
+				while (size < 64 && (array[size] = channel->m_list.deque())) {
+					size++;
+				}
+			} while (0);
+
+			for (int i = 0; i < size; i++) {
+				if (check) {
+					success(*(int64_t*)array[i] == next++);
+				}
+				if (remote) {
+					LocalFree(0, array[i]);
+				} else {
+					LocalAlloter(0)->_del(array[i]);
+				}
+			}
+			if (size == 0) {
+				if (done) {
+					break;
+				}
+				std::this_thread::yield();
+			}
+		}
+	}
+
+	void
+	remote_alloter_test()
+	{
+		do {
+			/** producer exit before consumer, piece go back by closed queue */
+			RemoteCount count(64);
+			RemoteChannel channel[4];
+			for (auto& c : channel) {
+				single(__remote_producer, &count, &c, (int64_t)100000, true, true);
+			}
+			thread_wait();
+			for (auto& c : channel) {
+				single(__remote_consumer, &count, &c, true, true);
+			}
+			thread_wait();
+			success(count.m_count == 0);
+
+			/** producer and consumer run together, also thread free itself */
+			RemoteChannel other[8];
+			for (auto& c : other) {
+				single(__remote_producer, &count, &c, (int64_t)100000, true, true);
+				single(__remote_consumer, &count, &c, true, true);
+			}
+			thread_wait();
+			success(count.m_count == 0);
+		} while (0);
+
+		const int64_t total = 1000000;
+		for (int pair = 1; pair <= 8; pair *= 2) {
+			for (bool remote : { false, true }) {
+				MemPool pool(MemConfig(64));
+				RemoteChannel channel[8];
+
+				CREATE_TIMER;
+				for (int i = 0; i < pair; i++) {
+					single(__remote_producer, (BaseAlloter*)&pool, &channel[i], total, remote, false);
+					single(__remote_consumer, (BaseAlloter*)&pool, &channel[i], remote, false);
+				}
+				thread_wait();
+
+				ctime_t time = timer.check();
+				log_info("local alloter " << (remote ? "remote free" : "local free ") << ", pair " << pair
+					<< ", ops " << string_iops(pair * total, time)
+					<< ", using " << string_timer(time));
+			}
+		}
+	}
 }
 }
 #endif
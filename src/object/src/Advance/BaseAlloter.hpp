@@ -76,6 +76,16 @@ namespace common
 		 **/
 		bool	owner() { return m_owner; }
 
+		/**
+		 * set account type, alloter holding memory account its piece
+		 **/
+		void	account(int type) { m_account = type; }
+
+		/**
+		 * get account type
+		 **/
+		int		account() { return m_account; }
+
 	protected:
 		/** piece length */
 		size_t	m_piece = {0};
@@ -83,16 +93,26 @@ namespace common
 		size_t	m_align = {0};
 		/** user owner alloter or not */
 		bool	m_owner = {false};
+		/** memory account type */
+		int		m_account = {0};
 	};
 
 	/**
 	 * set local alloter
+	 *
+	 * @param remote piece freed by other thread go back to owner thread queue,
+	 * 		  owner take them in bulk when refill; piece must freed by LocalFree
 	 **/
-	void	LocalAlloter(BaseAlloter* alloter, int type, int limit = 0, int batch = 0);
+	void	LocalAlloter(BaseAlloter* alloter, int type, int limit = 0, int batch = 0, bool remote = false);
 
 	/**
 	 * get local alloter
 	 **/
 	BaseAlloter* LocalAlloter(int type);
+
+	/**
+	 * free piece of remote mode local alloter, in any thread
+	 **/
+	void	LocalFree(int type, void* data);
 }
 
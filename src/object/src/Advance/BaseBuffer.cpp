@@ -136,4 +136,202 @@ BaseBuffer::write_string(void const* string)
 	return length + sizeof(length_t);
 }
 
+uint64_t
+BaseBuffer::read_varint()
+{
+	byte_t data[c_varint_max];
+	length_t len = std::min(length(), (length_t)sizeof(data));
+	peek(data, len);
+
+	uint64_t value = 0;
+	int used = varint_decode(data, len, value);
+	/** partial value not returned, wait rest data */
+	if (used == 0) {
+		return 0;
+	}
+	remove(used);
+	return value;
 }
+
+length_t
+BaseBuffer::write_delta(const int64_t* data, length_t count)
+{
+	byte_t temp[c_array_batch];
+	length_t pos = 0;
+	length_t ret = 0;
+	int64_t last = 0;
+	for (length_t i = 0; i < count; i++) {
+		if (pos + c_varint_max > (length_t)sizeof(temp)) {
+			ret += write(temp, pos);
+			pos = 0;
+		}
+		pos += varint_encode(temp + pos, zigzag_encode(data[i] - last));
+		last = data[i];
+	}
+	if (pos > 0) {
+		ret += write(temp, pos);
+	}
+	return ret;
+}
+
+length_t
+BaseBuffer::read_delta(int64_t* data, length_t count)
+{
+	byte_t temp[c_array_batch];
+	length_t index = 0;
+	int64_t last = 0;
+	while (index < count && length() > 0) {
+		length_t len = std::min(length(), (length_t)sizeof(temp));
+		peek(temp, len);
+
+		length_t pos = 0;
+		uint64_t value = 0;
+		int used = 0;
+		while (index < count && (used = varint_decode(temp + pos, len - pos, value)) > 0) {
+			last += zigzag_decode(value);
+			data[index++] = last;
+			pos += used;
+		}
+		/** last varint not complete */
+		if (pos == 0) {
+			break;
+		}
+		remove(pos);
+	}
+	return index;
+}
+
+}
+
+#if COMMON_TEST
+#include <vector>
+#include "Common/LogHelper.hpp"
+#include "Common/Display.hpp"
+#include "Advance/DynBuffer.hpp"
+#include "Advance/BufferStream.hpp"
+#include "Perform/Timer.hpp"
+
+namespace common {
+namespace tester {
+
+	template<class Type>
+	void	__buffer_array_check(bool convert, length_t count) {
+		std::vector<Type> origin(count), data(count);
+		for (length_t i = 0; i < count; i++) {
+			origin[i] = (Type)(((uint64_t)rand() << 32) | rand());
+		}
+		DynBuffer buffer;
+		buffer.cvt_byte(convert);
+		success(buffer.write_array(&origin[0], count) == count * (length_t)sizeof(Type));
+
+		/** same wire format as scalar api */
+		Type value = 0;
+		buffer.peek(&value, sizeof(value), sizeof(Type));
+		success((convert ? swap_int(value) : value) == origin[1]);
+		success(buffer.read_array(&data[0], count) == count && data == origin);
+
+		buffer << array_wrap(&origin[0], count);
+		buffer >> array_wrap(&data[0], count);
+		success(data == origin && buffer.length() == 0);
+	}
+
+	void
+	buffer_array_test()
+	{
+		/** simd kernel match scalar, for any length and offset */
+		byte_t src[1024], dst[1024], ref[1024];
+		for (int i = 0; i < (int)sizeof(src); i++) {
+			src[i] = (byte_t)rand();
+		}
+		for (int size = 2; size <= 8; size *= 2) {
+			for (int count = 0; count < 100; count++) {
+				int off = count % 8;
+				swap_array(dst, src + off, size, count);
+				swap_array_scalar(ref, src + off, size, count);
+				success(memcmp(dst, ref, size * count) == 0);
+			}
+		}
+		for (int convert = 0; convert < 2; convert++) {
+			__buffer_array_check<uint16_t>(convert, 1003);
+			__buffer_array_check<uint32_t>(convert, 100003);
+			__buffer_array_check<int64_t>(convert, 10007);
+		}
+
+		/** varint and zigzag */
+		DynBuffer buffer;
+		uint64_t unsign[] = { 0, 1, 127, 128, 16383, 16384, (uint64_t)1 << 63, UINT64_MAX };
+		int64_t sign[] = { 0, -1, 1, -64, 64, INT64_MIN, INT64_MAX };
+		for (auto v : unsign) {
+			buffer.write_varint(v);
+		}
+		for (auto v : sign) {
+			buffer.write_zigzag(v);
+		}
+		success(buffer.length() == 1 + 1 + 1 + 2 + 2 + 3 + 10 + 10 + (1 + 1 + 1 + 1 + 2 + 10 + 10));
+		for (auto v : unsign) {
+			success(buffer.read_varint() == v);
+		}
+		for (auto v : sign) {
+			success(buffer.read_zigzag() == v);
+		}
+		byte_t partial[] = { (byte_t)0xFF, (byte_t)0x81 };
+		buffer.write(partial, sizeof(partial));
+		success(buffer.read_varint() == 0 && buffer.length() == sizeof(partial));
+		buffer.clear();
+
+		/** delta run of sorted offset */
+		const length_t count = 1000000;
+		std::vector<int64_t> offset(count), result(count);
+		for (length_t i = 1; i < count; i++) {
+			offset[i] = offset[i - 1] + rand() % 4096;
+		}
+		length_t len = buffer.write_delta(&offset[0], count);
+		success(len == buffer.length() && buffer.read_delta(&result[0], count) == count);
+		success(result == offset && buffer.length() == 0);
+		log_info("delta run, " << count << " offset, encoded " << string_size(len)
+			<< ", " << (double)len / count << " byte each");
+
+		/** serialize index array, each int or in bulk */
+		std::vector<uint32_t> index(count), output(count);
+		for (length_t i = 0; i < count; i++) {
+			index[i] = rand();
+		}
+		buffer.cvt_byte(true);
+		for (int loop = 0; loop < 4; loop++) {
+			bool bulk = loop % 2;
+			CREATE_TIMER;
+			if (bulk) {
+				buffer.write_array(&index[0], count);
+				buffer.read_array(&output[0], count);
+			} else {
+				for (length_t i = 0; i < count; i++) {
+					buffer.write_int32(index[i]);
+				}
+				for (length_t i = 0; i < count; i++) {
+					output[i] = buffer.read_int32();
+				}
+			}
+			ctime_t time = timer.check();
+			success(output == index);
+			log_info("index array, " << (bulk ? "bulk " : "each ") << (bulk ? swap_kernel() : "scalar") << ", "
+				<< string_iops(count * 2, time) << " ops/s");
+		}
+
+		for (int loop = 0; loop < 4; loop++) {
+			bool simd = loop % 2;
+			CREATE_TIMER;
+			for (int i = 0; i < 100; i++) {
+				if (simd) {
+					swap_array(&output[0], &index[0], sizeof(uint32_t), count);
+				} else {
+					swap_array_scalar(&output[0], &index[0], sizeof(uint32_t), count);
+				}
+			}
+			ctime_t time = timer.check();
+			log_info("swap array, " << (simd ? swap_kernel() : "scalar") << ", "
+				<< string_speed((int64_t)100 * count * sizeof(uint32_t), time));
+		}
+	}
+}
+}
+#endif
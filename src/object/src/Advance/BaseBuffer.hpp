@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "Common/Type.hpp"
 #include "Common/Const.hpp"
 #include "CodeHelper/Validate.hpp"
@@ -259,6 +261,95 @@ namespace common {
 		 */
 		length_t	write_string(void const* str);
 
+	public:
+		/**
+		 * @brief write int array in one write
+		 * @param data array start
+		 * @param count int count
+		 * @return actually writted len
+		 * @note convert byte order in batch if needed
+		 */
+		template<class Type>
+		length_t	write_array(const Type* data, length_t count) {
+			if (sizeof(Type) == 1 || !cvt_byte()) {
+				return write(data, count * sizeof(Type));
+			}
+			Type temp[c_array_batch / sizeof(Type)];
+			length_t pos = 0;
+			length_t ret = 0;
+			while (pos < count) {
+				length_t size = std::min(count - pos, (length_t)(c_array_batch / sizeof(Type)));
+				common::swap_array(temp, data + pos, sizeof(Type), size);
+				ret += write(temp, size * sizeof(Type));
+				pos += size;
+			}
+			return ret;
+		}
+
+		/**
+		 * @brief read int array in one peek
+		 * @param data dest array start
+		 * @param count int count
+		 * @return actually readed count
+		 * @note convert byte order in batch if needed
+		 */
+		template<class Type>
+		length_t	read_array(Type* data, length_t count) {
+			count = std::min(count, (length_t)(length() / sizeof(Type)));
+			length_t len = count * sizeof(Type);
+			peek(data, len);
+			remove(len);
+			if (sizeof(Type) > 1 && cvt_byte()) {
+				common::swap_array(data, data, sizeof(Type), count);
+			}
+			return count;
+		}
+
+		/**
+		 * @brief write varint
+		 * @return actually writted len
+		 */
+		length_t	write_varint(uint64_t value) {
+			byte_t data[c_varint_max];
+			return write(data, varint_encode(data, value));
+		}
+
+		/**
+		 * @brief read varint
+		 * @note 0 and nothing removed if data not complete
+		 */
+		uint64_t	read_varint();
+
+		/**
+		 * @brief write signed int as zigzag varint
+		 * @return actually writted len
+		 */
+		length_t	write_zigzag(int64_t value) { return write_varint(zigzag_encode(value)); }
+
+		/**
+		 * @brief read zigzag varint
+		 */
+		int64_t		read_zigzag() { return zigzag_decode(read_varint()); }
+
+		/**
+		 * @brief write int run as zigzag varint of delta to previous
+		 * @param data int array, sorted offset or index cost 1 or 2 byte each
+		 * @param count int count
+		 * @return actually writted len
+		 */
+		length_t	write_delta(const int64_t* data, length_t count);
+
+		/**
+		 * @brief read delta encoded int run
+		 * @param data dest array
+		 * @param count int count
+		 * @return actually readed count
+		 */
+		length_t	read_delta(int64_t* data, length_t count);
+
+		/** bulk convert batch length */
+		static const length_t c_array_batch = 4096;
+
 	public:
 		/**
 		 * @brief current data length
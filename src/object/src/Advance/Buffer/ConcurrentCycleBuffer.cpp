@@ -0,0 +1,341 @@
+
+#include <ctime>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#include "Common/Atomic.hpp"
+#include "Advance/Buffer/ConcurrentCycleBuffer.hpp"
+
+namespace common {
+
+/**
+ * wait on futex while value not changed, timeout in ms
+ **/
+static void
+futex_wait(volatile int* futex, int value, int timeout)
+{
+	struct timespec time;
+	time.tv_sec = timeout / 1000;
+	time.tv_nsec = (timeout % 1000) * 1000000L;
+	syscall(SYS_futex, futex, FUTEX_WAIT_PRIVATE, value, &time, NULL, 0);
+}
+
+ConcurrentCycleBuffer::ConcurrentCycleBuffer(length_t len, bool multi, bool block)
+	: m_multi(multi), m_block(block)
+{
+	length_t size = c_page_size;
+	while (size < len) {
+		size <<= 1;
+	}
+	if (m_buffer.set_len(size, true)) {
+		m_data = m_buffer.m_data;
+		m_mask = size - 1;
+	}
+}
+
+byte_t*
+ConcurrentCycleBuffer::reserve(length_t len)
+{
+	length_t size = record(len);
+	volatile uint32_t* head = NULL;
+
+	if (m_multi) {
+		int64_t tail = m_tail;
+		while (true) {
+			/** acquire pair with release, old data cleared before reuse */
+			if (tail + size - atomic_load_acquire(&m_head) > total()) {
+				return NULL;
+			}
+			int64_t prev = atomic_comp_swap64(&m_tail, tail + size, tail);
+			if (prev == tail) {
+				break;
+			}
+			tail = prev;
+		}
+		head = header(tail);
+
+	} else {
+		if (m_pending + size - m_head_cache > total()) {
+			m_head_cache = atomic_load_acquire(&m_head);
+			if (m_pending + size - m_head_cache > total()) {
+				return NULL;
+			}
+		}
+		head = header(m_pending);
+		m_pending += size;
+	}
+	/** not committed yet, consumer stop here */
+	atomic_store_release(head, len);
+	return (byte_t*)head + sizeof(uint32_t);
+}
+
+void
+ConcurrentCycleBuffer::publish()
+{
+	if (!m_multi) {
+		/** record data visible before tail */
+		atomic_store_release(&m_tail, m_pending);
+	}
+	if (m_block) {
+		signal(m_data_signal, m_data_waiter);
+	}
+}
+
+bool
+ConcurrentCycleBuffer::write(const void* data, length_t len)
+{
+	byte_t* ptr = reserve(len);
+	if (!ptr) {
+		return false;
+	}
+	memcpy(ptr, data, len);
+	commit(ptr);
+	publish();
+	return true;
+}
+
+const byte_t*
+ConcurrentCycleBuffer::read(length_t& len)
+{
+	/** acquire in readable, record data read after it */
+	if (!readable()) {
+		return NULL;
+	}
+
+	volatile uint32_t* head = header(m_read);
+	len = *head & ~cycle::c_commit;
+	m_read += record(len);
+	return (const byte_t*)head + sizeof(uint32_t);
+}
+
+void
+ConcurrentCycleBuffer::release()
+{
+	/**
+	 * next round header may land in old record data, clear it, consumer
+	 * stop there until producer commit
+	 **/
+	if (m_multi) {
+		memset(m_data + (m_head & m_mask), 0, m_read - m_head);
+	}
+	/** record data read and cleared before space given back */
+	atomic_store_release(&m_head, m_read);
+	if (m_block) {
+		signal(m_space_signal, m_space_waiter);
+	}
+}
+
+int
+ConcurrentCycleBuffer::consume(BaseBuffer::data_handle_t handle, void* ptr, int count)
+{
+	int index = 0;
+	length_t len = 0;
+	const byte_t* data = NULL;
+	while (index < count && (data = read(len))) {
+		handle(ptr, data, len);
+		index++;
+	}
+	if (index > 0) {
+		release();
+	}
+	return index;
+}
+
+void
+ConcurrentCycleBuffer::signal(volatile int& futex, volatile int& waiter)
+{
+	/** counter store visible before check waiter, pair with fence in wait */
+	atomic_fence();
+	if (waiter > 0) {
+		at_inc(futex);
+		syscall(SYS_futex, &futex, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+	}
+}
+
+bool
+ConcurrentCycleBuffer::wait(int timeout)
+{
+	assert(m_block);
+	if (readable()) {
+		return true;
+	}
+	int value = m_data_signal;
+	at_inc(m_data_waiter);
+	atomic_fence();
+	if (!readable()) {
+		futex_wait(&m_data_signal, value, timeout);
+	}
+	at_dec(m_data_waiter);
+	return readable();
+}
+
+bool
+ConcurrentCycleBuffer::wait_space(length_t len, int timeout)
+{
+	assert(m_block);
+	if (writable(len)) {
+		return true;
+	}
+	int value = m_space_signal;
+	at_inc(m_space_waiter);
+	atomic_fence();
+	if (!writable(len)) {
+		futex_wait(&m_space_signal, value, timeout);
+	}
+	at_dec(m_space_waiter);
+	return writable(len);
+}
+}
+
+#if COMMON_TEST
+#include <mutex>
+#include <string>
+#include "Common/LogHelper.hpp"
+#include "Common/Display.hpp"
+#include "Common/TypeQueue.hpp"
+#include "Perform/Debug.hpp"
+#include "Perform/Timer.hpp"
+
+namespace common {
+namespace tester {
+
+	const int c_cycle_record = 64;
+
+	/**
+	 * record carry producer and sequence
+	 **/
+	struct CycleRecord
+	{
+		int64_t	producer;
+		int64_t	sequence;
+		byte_t	data[c_cycle_record - 16];
+	};
+
+	void
+	__cycle_produce(ConcurrentCycleBuffer* buffer, int producer, int64_t count, int batch)
+	{
+		CycleRecord record = {};
+		record.producer = producer;
+		int64_t index = 0;
+		while (index < count) {
+			int pending = 0;
+			byte_t* data = NULL;
+			while (pending < batch && index < count && (data = buffer->reserve(sizeof(record)))) {
+				record.sequence = index++;
+				memcpy(data, &record, sizeof(record));
+				buffer->commit(data);
+				pending++;
+			}
+			if (pending > 0) {
+				buffer->publish();
+			} else {
+				buffer->wait_space(sizeof(record), 1);
+			}
+		}
+	}
+
+	struct CycleCheck
+	{
+		int64_t	next[16] = {};
+		int64_t	total = { 0 };
+	};
+
+	length_t
+	__cycle_check(void* ptr, const byte_t* data, length_t len)
+	{
+		CycleCheck* check = (CycleCheck*)ptr;
+		const CycleRecord* record = (const CycleRecord*)data;
+		success(len == sizeof(CycleRecord));
+		/** order kept for each producer */
+		success(record->sequence == check->next[record->producer]++);
+		check->total++;
+		return len;
+	}
+
+	void
+	__cycle_ring(bool multi, int producer, int64_t count, int batch)
+	{
+		ConcurrentCycleBuffer buffer(c_length_64K * 4, multi, true);
+		success(buffer.valid());
+
+		CREATE_TIMER;
+		for (int i = 0; i < producer; i++) {
+			single(__cycle_produce, &buffer, i, count, batch);
+		}
+		CycleCheck check;
+		while (check.total < count * producer) {
+			if (buffer.consume(__cycle_check, &check, batch) == 0) {
+				buffer.wait(1);
+			}
+		}
+		thread_wait();
+		ctime_t time = timer.check();
+		success(buffer.length() == 0);
+		log_info("cycle ring, " << (multi ? "mpsc" : "spsc") << " producer " << producer << " batch " << batch
+			<< ", " << string_iops(count * producer, time) << " ops/s");
+	}
+
+	void
+	__cycle_queue_produce(std::mutex* mutex, TypeQueue<std::string>* queue, int64_t count)
+	{
+		std::string record(c_cycle_record, 0);
+		for (int64_t i = 0; i < count; i++) {
+			std::lock_guard<std::mutex> lock(*mutex);
+			queue->enque(record);
+		}
+	}
+
+	void
+	concurrent_cycle_test()
+	{
+		/** header commit, space reuse across round */
+		ConcurrentCycleBuffer buffer(c_page_size, true);
+		length_t len = 0;
+		success(buffer.total() == c_page_size && buffer.read(len) == NULL);
+		byte_t* first = buffer.reserve(100);
+		byte_t* second = buffer.reserve(200);
+		buffer.commit(second);
+		success(buffer.read(len) == NULL);
+		buffer.commit(first);
+		success(buffer.read(len) == first && len == 100);
+		success(buffer.read(len) == second && len == 200);
+		buffer.release();
+		for (int i = 0; i < 1000; i++) {
+			success(buffer.write(&i, sizeof(i)));
+			success(*(int*)buffer.read(len) == i && len == sizeof(i));
+			buffer.release();
+		}
+		while (buffer.reserve(1000) || buffer.reserve(1)) {}
+		success(!buffer.write(&len, 1) && buffer.length() == buffer.total());
+
+		const int64_t count = 2000000;
+		for (int loop = 0; loop < 2; loop++) {
+			__cycle_ring(false, 1, count, 1);
+			__cycle_ring(false, 1, count, 32);
+			__cycle_ring(true, 4, count / 4, 32);
+
+			/** mutex protected queue handoff */
+			std::mutex mutex;
+			TypeQueue<std::string> queue;
+			CREATE_TIMER;
+			single(__cycle_queue_produce, &mutex, &queue, count);
+			int64_t total = 0;
+			while (total < count) {
+				std::lock_guard<std::mutex> lock(mutex);
+				while (!queue.empty()) {
+					queue.deque();
+					total++;
+				}
+			}
+			thread_wait();
+			ctime_t time = timer.check();
+			log_info("mutex queue, " << string_iops(count, time) << " ops/s");
+		}
+	}
+}
+}
+#endif
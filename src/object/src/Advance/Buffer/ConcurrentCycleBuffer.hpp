@@ -0,0 +1,202 @@
+
+#pragma once
+
+#include "Common/Define.hpp"
+#include "Common/Atomic.hpp"
+#include "Advance/Buffer/CycleBuffer.hpp"
+
+namespace common
+{
+	namespace cycle {
+		/** record header committed bit, for multi producer */
+		static const uint32_t c_commit = 0x80000000;
+		/** record align */
+		static const int c_align = 8;
+		/** keep producer and consumer counter in different cache line */
+		static const int c_cache_line = 64;
+	}
+
+	/**
+	 * @brief bounded ring of length prefixed record, single consumer,
+	 * single or multi producer
+	 * @note buffer mapped twice, record never split; counter increase only,
+	 * position is counter & mask
+	 * @note single producer: reserve records, publish batch by one tail store;
+	 * multi producer: reserve by cas, commit each record by its header, consumer
+	 * clear released space
+	 */
+	class ConcurrentCycleBuffer
+	{
+	public:
+		/**
+		 * @param len buffer length, round to 2-exp and page aligned
+		 * @param multi allow multi producer or not
+		 * @param block support futex wait or not, publish and release cost
+		 * one fence more
+		 */
+		ConcurrentCycleBuffer(length_t len, bool multi = false, bool block = false);
+
+		/** mirror mapping owned, not copy */
+		ConcurrentCycleBuffer(const ConcurrentCycleBuffer&) = delete;
+		ConcurrentCycleBuffer& operator = (const ConcurrentCycleBuffer&) = delete;
+
+	public:
+		/**
+		 * @brief reserve space for record
+		 * @param len record data length
+		 * @return record data start, NULL if no space
+		 */
+		byte_t*		reserve(length_t len);
+
+		/**
+		 * @brief record data filled
+		 * @note for multi producer, record visible to consumer after commit
+		 */
+		void		commit(byte_t* data) {
+			if (m_multi) {
+				volatile uint32_t* head = (volatile uint32_t*)(data - sizeof(uint32_t));
+				/** length stored by this producer in reserve, data visible before commit bit */
+				atomic_store_release(head, *head | cycle::c_commit);
+			}
+		}
+
+		/**
+		 * @brief publish committed records, wake consumer
+		 */
+		void		publish();
+
+		/**
+		 * @brief write one record and publish
+		 * @return false if no space
+		 */
+		bool		write(const void* data, length_t len);
+
+		/**
+		 * @brief wait until space enough for record
+		 * @param timeout wait time, ms
+		 */
+		bool		wait_space(length_t len, int timeout);
+
+	public:
+		/**
+		 * @brief read next record, space kept until release
+		 * @param len record data length
+		 * @return record data start, NULL if none
+		 */
+		const byte_t* read(length_t& len);
+
+		/**
+		 * @brief give back space of records already read
+		 */
+		void		release();
+
+		/**
+		 * @brief handle records in batch, release once
+		 * @param handle record handle
+		 * @param ptr handle param
+		 * @param count max record count
+		 * @return record count handled
+		 */
+		int			consume(BaseBuffer::data_handle_t handle, void* ptr, int count = INT32_MAX);
+
+		/**
+		 * @brief wait until record readable
+		 * @param timeout wait time, ms
+		 */
+		bool		wait(int timeout);
+
+	public:
+		/**
+		 * @brief check if buffer mapped
+		 */
+		bool		valid() const { return m_data != NULL; }
+
+		/**
+		 * @brief buffer length
+		 */
+		length_t	total() const { return m_mask + 1; }
+
+		/**
+		 * @brief space used, not exactly when concurrent
+		 */
+		length_t	length() const { return m_tail - m_head; }
+
+		/**
+		 * @brief record length with header and align
+		 */
+		static length_t	record(length_t len) {
+			return (len + sizeof(uint32_t) + cycle::c_align - 1) & ~(cycle::c_align - 1);
+		}
+
+	protected:
+		/**
+		 * @brief get record header of counter
+		 */
+		volatile uint32_t* header(int64_t pos) const {
+			return (volatile uint32_t*)(m_data + (pos & m_mask));
+		}
+
+		/**
+		 * @brief check if next record readable
+		 */
+		bool		readable() {
+			if (m_multi) {
+				return (atomic_load_acquire(header(m_read)) & cycle::c_commit) != 0;
+			}
+			return m_read != atomic_load_acquire(&m_tail);
+		}
+
+		/**
+		 * @brief check if space enough for record
+		 */
+		bool		writable(length_t len) {
+			int64_t tail = m_multi ? m_tail : m_pending;
+			return tail + record(len) - atomic_load_acquire(&m_head) <= total();
+		}
+
+		/**
+		 * @brief wake waiter on futex
+		 */
+		void		signal(volatile int& futex, volatile int& waiter);
+
+	protected:
+		/** mirror mapped buffer */
+		CycleBuffer	m_buffer;
+		/** buffer data start */
+		byte_t*		m_data = { NULL };
+		/** position mask */
+		int64_t		m_mask = { -1 };
+		/** multi producer */
+		bool		m_multi = { false };
+		/** support wait */
+		bool		m_block = { false };
+
+		char		m_pad0[cycle::c_cache_line];
+		/** published end for single producer, reserved end for multi producer */
+		volatile int64_t m_tail = { 0 };
+		/** reserved end of single producer, not published */
+		int64_t		m_pending = { 0 };
+		/** head seen by single producer */
+		int64_t		m_head_cache = { 0 };
+		/** futex of space released */
+		volatile int m_space_signal = { 0 };
+		/** producer waiting for space */
+		volatile int m_space_waiter = { 0 };
+
+		char		m_pad1[cycle::c_cache_line];
+		/** released end */
+		volatile int64_t m_head = { 0 };
+		/** read end of consumer, not released */
+		int64_t		m_read = { 0 };
+		/** futex of record published */
+		volatile int m_data_signal = { 0 };
+		/** consumer waiting for record */
+		volatile int m_data_waiter = { 0 };
+
+		char		m_pad2[cycle::c_cache_line];
+	};
+}
+
+#if COMMON_SPACE
+	using common::ConcurrentCycleBuffer;
+#endif
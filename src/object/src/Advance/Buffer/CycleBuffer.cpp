@@ -1,12 +1,88 @@
 
 #include <cstring>
 #include <algorithm>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 
 #include "Common/Define.hpp"
+#include "Advance/Util.hpp"
 #include "Advance/Buffer/CycleBuffer.hpp"
 
 namespace common {
 
+/**
+ * map memfd twice back to back, write to one half visible in the other
+ **/
+static byte_t*
+mirror_map(length_t len)
+{
+	int fd = syscall(SYS_memfd_create, "cycle buffer", 0);
+	if (fd < 0) {
+		return NULL;
+	}
+
+	byte_t* data = NULL;
+	if (ftruncate(fd, len) == 0) {
+		/** reserve address space first, then replace each half */
+		void* addr = mmap(NULL, (size_t)len * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (addr != MAP_FAILED) {
+			byte_t* half = (byte_t*)addr + len;
+			if (mmap(addr, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == addr &&
+				mmap(half, len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == half)
+			{
+				data = (byte_t*)addr;
+			} else {
+				munmap(addr, (size_t)len * 2);
+			}
+		}
+	}
+	close(fd);
+	return data;
+}
+
+bool
+CycleBuffer::set_len(length_t len, bool mirror)
+{
+	release();
+	if (!mirror) {
+		ByteBuffer::malloc(len);
+		return m_data != NULL;
+	}
+
+	len = up_align(len, c_page_size);
+	byte_t* data = mirror_map(len);
+	if (!data) {
+		return false;
+	}
+	attach(data, len, false);
+	m_mirror = true;
+	return true;
+}
+
+void
+CycleBuffer::release()
+{
+	if (m_mirror) {
+		munmap(m_data, (size_t)m_total * 2);
+		m_mirror = false;
+	}
+	ByteBuffer::clear(true);
+	clear();
+}
+
+length_t
+CycleBuffer::commit(length_t len)
+{
+	success(len <= wsize());
+	m_end += len;
+	if (m_end >= m_total) {
+		m_end -= m_total;
+	}
+	inc(len);
+	return len;
+}
+
 length_t
 CycleBuffer::dispatch(data_handle_t handle, void* ptr,
 	length_t len, length_t off) const
@@ -17,8 +93,8 @@ CycleBuffer::dispatch(data_handle_t handle, void* ptr,
 	len = std::min(length() - off, len);
 
 	length_t remain = m_total - m_start;
-	/** data before tail match what we need */
-	if (off + len <= remain) {
+	/** data before tail match what we need, or mapped after tail */
+	if (m_mirror || off + len <= remain) {
 		handle(ptr, rpos(off), len);
 
 	/** we need more data */
@@ -43,19 +119,132 @@ CycleBuffer::write(const void* _data, length_t len)
     const byte_t* data = (const byte_t*)_data;
 	/** data before tail match what we need, maybe end > start or end < start,
 		but write end will never exceed remain space */
-	if (len <= remain) {
+	if (m_mirror || len <= remain) {
 		memcpy(wpos(), data, len);
-		m_end += len;
 
 	/** we need write wrap */
 	} else {
 		memcpy(wpos(), data, remain);
 		memcpy(m_data, data + remain, len - remain);
-		m_end = len - remain;
 	}
 
+	m_end += len;
+	if (m_end >= m_total) {
+		m_end -= m_total;
+	}
 	inc(len);
 	return len;
 }
 
 }
+
+#if COMMON_TEST
+#include <string>
+#include "Common/LogHelper.hpp"
+#include "Common/Display.hpp"
+#include "Perform/Timer.hpp"
+
+namespace common {
+namespace tester {
+
+	/**
+	 * consume record, copy out if not contiguous
+	 **/
+	uint64_t
+	__cycle_record(CycleBuffer& buffer, byte_t* temp)
+	{
+		uint32_t len = 0;
+		buffer.peek(&len, sizeof(len));
+		const byte_t* data = buffer.rpos(sizeof(len));
+		if (buffer.rsize() < (length_t)(sizeof(len) + len)) {
+			buffer.peek(temp, len, sizeof(len));
+			data = temp;
+		}
+		uint64_t sum = (uint8_t)data[0] + (uint8_t)data[len - 1];
+		buffer.remove(sizeof(len) + len);
+		return sum;
+	}
+
+	void
+	cycle_buffer_test()
+	{
+		byte_t record[1024];
+		byte_t temp[1024];
+		for (int i = 0; i < (int)sizeof(record); i++) {
+			record[i] = (byte_t)i;
+		}
+
+		for (int mirror = 0; mirror < 2; mirror++) {
+			CycleBuffer buffer(c_length_64K, mirror);
+			success(buffer.mirror() == (bool)mirror && buffer.total() == c_length_64K);
+
+			/** length prefixed record, wrap many times */
+			for (int i = 0; i < 100000; i++) {
+				uint32_t len = rand() % 1000 + 1;
+				while (buffer.remain() < (length_t)(sizeof(len) + len)) {
+					uint32_t size = 0;
+					buffer.peek(&size, sizeof(size));
+					buffer.peek(temp, size, sizeof(size));
+					success(memcmp(temp, record, size) == 0);
+					if (mirror) {
+						success(buffer.rsize() == buffer.length());
+						success(memcmp(buffer.rpos(sizeof(size)), record, size) == 0);
+					}
+					buffer.remove(sizeof(size) + size);
+				}
+				buffer.write(&len, sizeof(len));
+				buffer.write(record, len);
+			}
+
+			/** direct syscall on contiguous region */
+			int fd[2];
+			success(pipe(fd) == 0);
+			std::string origin;
+			buffer.dispatch([](void* ptr, const byte_t* data, length_t len) {
+				((std::string*)ptr)->append((const char*)data, len);
+				return len;
+			}, &origin);
+			while (buffer.length() > 0) {
+				length_t len = ::write(fd[1], buffer.rpos(), buffer.rsize());
+				success(len > 0);
+				buffer.remove(len);
+			}
+			std::string data;
+			while (data.length() < origin.length()) {
+				length_t len = ::read(fd[0], buffer.wpos(), buffer.wsize());
+				success(len > 0);
+				buffer.commit(len);
+				data.append((const char*)buffer.rpos(), buffer.rsize());
+				buffer.remove(buffer.rsize());
+			}
+			success(data == origin);
+			close(fd[0]);
+			close(fd[1]);
+		}
+
+		/** record handoff, copy out when split, or use rpos directly */
+		const int count = 2000000;
+		for (int loop = 0; loop < 4; loop++) {
+			int mirror = loop % 2;
+			CycleBuffer buffer(c_length_64K, mirror);
+			uint64_t sum = 0;
+
+			CREATE_TIMER;
+			for (int i = 0; i < count; i++) {
+				uint32_t len = 100 + i % 900;
+				if (buffer.remain() < (length_t)(sizeof(len) + len)) {
+					while (buffer.length() > 0) {
+						sum += __cycle_record(buffer, temp);
+					}
+				}
+				buffer.write(&len, sizeof(len));
+				buffer.write(record, len);
+			}
+			ctime_t time = timer.check();
+			log_info("cycle record, " << (mirror ? "mirror" : "normal") << ", "
+				<< string_iops(count, time) << " ops/s, sum " << sum);
+		}
+	}
+}
+}
+#endif
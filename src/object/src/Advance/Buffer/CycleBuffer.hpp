@@ -1,15 +1,31 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "Advance/Buffer/ByteBuffer.hpp"
 
 namespace common
 {
+	/**
+	 * @brief cycle buffer, data wrap to head when reach tail
+	 * @note in mirror mode, same memory mapped twice back to back, data
+	 * and space at rpos and wpos always contiguous
+	 */
 	class CycleBuffer : public ByteBuffer
 	{
 	public:
-		CycleBuffer();
-		virtual ~CycleBuffer();
+		CycleBuffer() {}
+
+		/**
+		 * @param len buffer length
+		 * @param mirror map buffer twice or not
+		 */
+		CycleBuffer(length_t len, bool mirror = false) {
+			set_len(len, mirror);
+		}
+
+		virtual ~CycleBuffer() { release(); }
 
 	public:
 		/** 
@@ -49,17 +65,65 @@ namespace common
 		 */
 		void		clear() {
 			m_length = 0;
+			m_start = 0;
 			m_end = 0;
 		}
 
 		/** 
-		 * @brief set new buffer len
+		 * @brief set new buffer len, old data dropped
+		 * @param len buffer length, page aligned in mirror mode
+		 * @param mirror map buffer twice or not
 		 */
-		bool		set_len(length_t len);
+		bool		set_len(length_t len, bool mirror = false);
+
+		/**
+		 * @brief check if in mirror mode
+		 **/
+		bool		mirror() const { return m_mirror; }
+
+	public:
+		/** 
+		 * @brief write pos
+		 */
+		byte_t*		wpos() { return m_data + m_end; }
+
+		/** 
+		 * @brief contiguous data length at rpos
+		 */
+		length_t	rsize() const {
+			return m_mirror ? m_length : std::min(m_length, m_total - m_start);
+		}
+
+		/** 
+		 * @brief contiguous space length at wpos
+		 */
+		length_t	wsize() const {
+			length_t remain = m_total - m_length;
+			return m_mirror ? remain : std::min(remain, m_total - m_end);
+		}
+
+		/** 
+		 * @brief add data already filled at wpos, for zero copy write
+		 * @param len filled length, not exceed wsize
+		 */
+		length_t	commit(length_t len);
 
 	protected:
+		/** 
+		 * @brief free buffer space
+		 */
+		void		release();
+
+	protected:
+		/** data end off */
 		length_t	m_end = {0};
+		/** map buffer twice */
+		bool		m_mirror = {false};
 	};
 
 }
 
+#if COMMON_SPACE
+	using common::CycleBuffer;
+#endif
+
@@ -54,6 +54,45 @@ namespace common {
 		return packet;
 	}
 
+	/**
+	 * @brief int array wrap, stream in one bulk call
+	 */
+	template<class Type>
+	struct ArrayWrap {
+		/** array start */
+		Type*	_data;
+		/** int count */
+		length_t _count;
+	};
+
+	/**
+	 * @brief make array wrap
+	 */
+	template<class Type>
+	inline ArrayWrap<Type> array_wrap(Type* data, length_t count) {
+		return ArrayWrap<Type>{ data, count };
+	}
+
+	/**
+	 * @brief input int array with swap
+	 */
+	template<class Type>
+	inline BaseBuffer& operator << (BaseBuffer& buffer, const ArrayWrap<Type>& wrap) {
+		length_t len = buffer.write_array(wrap._data, wrap._count);
+		success(len == wrap._count * (length_t)sizeof(Type));
+		return buffer;
+	}
+
+	/**
+	 * @brief output int array with swap
+	 */
+	template<class Type>
+	inline BaseBuffer& operator >> (BaseBuffer& buffer, const ArrayWrap<Type>& wrap) {
+		length_t count = buffer.read_array(wrap._data, wrap._count);
+		success(count == wrap._count);
+		return buffer;
+	}
+
 	/** 
 	 * @brief output bool with swap
 	 */
@@ -89,14 +128,14 @@ namespace common {
 	/** 
 	 * read string
 	 **/
-	length_t 	read_string(BaseBuffer& buffer, std::string& str) {
+	inline length_t read_string(BaseBuffer& buffer, std::string& str) {
 		return buffer.read_string(&str);
 	}
 
 	/**
 	 * read string
 	 **/
-	length_t    write_string(BaseBuffer& buffer, std::string& str) {
+	inline length_t write_string(BaseBuffer& buffer, std::string& str) {
 		return buffer.write_string(&str);
 	}
 
@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include "Common/Type.hpp"
+
 namespace common {
 
 	/** local indian, nbo or not nbo (lte) */
@@ -35,6 +37,71 @@ namespace common {
 		return type;
 	}
 
+	/**
+	 * @brief swap int array, use avx2 or ssse3 shuffle if cpu support
+	 * @param dst dest array, may same as src
+	 * @param src source array
+	 * @param size int size, 2, 4 or 8
+	 * @param count int count
+	 **/
+	void	swap_array(void* dst, const void* src, int size, length_t count);
+
+	/**
+	 * @brief swap int array, scalar only
+	 **/
+	void	swap_array_scalar(void* dst, const void* src, int size, length_t count);
+
+	/**
+	 * @brief get swap kernel used by swap_array, avx2, ssse3 or scalar
+	 **/
+	const char* swap_kernel();
+
+	/** max varint length of 64 bit int */
+	const int c_varint_max = 10;
+
+	/**
+	 * @brief zigzag encode, small negative to small unsigned
+	 **/
+	inline uint64_t zigzag_encode(int64_t value) {
+		return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+	}
+
+	/**
+	 * @brief zigzag decode
+	 **/
+	inline int64_t zigzag_decode(uint64_t value) {
+		return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+	}
+
+	/**
+	 * @brief encode varint, 7 bit each byte, low group first
+	 * @return encoded length
+	 **/
+	inline int varint_encode(byte_t* data, uint64_t value) {
+		int len = 0;
+		while (value >= 0x80) {
+			data[len++] = (byte_t)(value | 0x80);
+			value >>= 7;
+		}
+		data[len++] = (byte_t)value;
+		return len;
+	}
+
+	/**
+	 * @brief decode varint
+	 * @return decoded length, 0 if data not complete
+	 **/
+	inline int varint_decode(const byte_t* data, length_t len, uint64_t& value) {
+		value = 0;
+		for (int i = 0; i < len && i < c_varint_max; i++) {
+			value |= (uint64_t)(data[i] & 0x7F) << (7 * i);
+			if ((data[i] & 0x80) == 0) {
+				return i + 1;
+			}
+		}
+		return 0;
+	}
+
 	/**
 	 * @brief convert int16 byte order between host and net
 	 */
@@ -0,0 +1,95 @@
+
+#pragma once
+
+#include <memory>
+
+#include "Common/Mutex.hpp"
+
+namespace common
+{
+	/**
+	 * thread cache slot, each lock free owner (pool or alloter) take one slot,
+	 * each thread keep one cache for each slot
+	 *
+	 * @note Cache need member m_owner, owner need detach(Cache*) to take back
+	 * 		 piece when thread exit; slot mutex protect cache attach and detach
+	 */
+	template<class Cache, int c_count>
+	class CacheSlot
+	{
+	public:
+		/**
+		 * slot of this cache type
+		 **/
+		static CacheSlot& instance() {
+			static CacheSlot s_slot;
+			return s_slot;
+		}
+
+		/**
+		 * get cache of slot in local thread, NULL if not created
+		 **/
+		static Cache*& local(int slot) {
+			thread_local std::shared_ptr<Local> s_local;
+			if (!s_local) {
+				s_local = std::make_shared<Local>();
+			}
+			return s_local->m_array[slot];
+		}
+
+	public:
+		/**
+		 * alloc free slot, -1 if all in used
+		 **/
+		int		alloc() {
+			Mutex::Locker lock(m_mutex);
+			for (int i = 0; i < c_count; i++) {
+				if (!m_used[i]) {
+					m_used[i] = true;
+					return i;
+				}
+			}
+			return -1;
+		}
+
+		/**
+		 * free slot
+		 **/
+		void	free(int slot) { m_used[slot] = false; }
+
+		/**
+		 * get slot mutex
+		 **/
+		Mutex&	mutex() { return m_mutex; }
+
+	protected:
+		/**
+		 * cache array of local thread, detach from owner when thread exit
+		 **/
+		struct Local
+		{
+			~Local() {
+				Mutex::Locker lock(instance().mutex());
+				for (auto cache : m_array) {
+					if (cache) {
+						if (cache->m_owner) {
+							cache->m_owner->detach(cache);
+						}
+						delete cache;
+					}
+				}
+			}
+
+			Cache*	m_array[c_count] = {};
+		};
+
+	protected:
+		Mutex	m_mutex = { "cache slot" };
+		/** slot used status */
+		bool	m_used[c_count] = {};
+	};
+}
+
+#if COMMON_SPACE
+	using common::CacheSlot;
+#endif
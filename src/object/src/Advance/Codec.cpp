@@ -0,0 +1,505 @@
+
+#include <cstring>
+#include <algorithm>
+
+#if USING_ZSTD
+#	include <zstd.h>
+#endif
+#if USING_LZ4
+#	include <lz4.h>
+#endif
+
+#include "Advance/DynBuffer.hpp"
+#include "Advance/Codec.hpp"
+
+namespace common {
+
+	static inline uint32_t
+	read32(const byte_t* data) {
+		uint32_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	static inline uint64_t
+	read64(const byte_t* data) {
+		uint64_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	void
+	Codec::flush(const byte_t* data, length_t len)
+	{
+		length_t cap = bound(len);
+		m_output.resize(sizeof(uint32_t) + cap);
+		length_t size = encode(data, len, &m_output[sizeof(uint32_t)], cap);
+
+		/** not compressible, keep raw */
+		uint32_t head = size;
+		if (size <= 0 || size >= len) {
+			head = len | codec::c_stored;
+			size = len;
+			memcpy(&m_output[sizeof(uint32_t)], data, len);
+		}
+		memcpy(&m_output[0], &head, sizeof(head));
+
+		size += sizeof(uint32_t);
+		if (m_crc) {
+			m_dst->write(&m_output[0], size, *m_crc);
+		} else {
+			m_dst->write(&m_output[0], size);
+		}
+		m_total += size;
+	}
+
+	length_t
+	Codec::compress_handle(void* ptr, const byte_t* data, length_t len)
+	{
+		Codec* codec = (Codec*)ptr;
+		length_t pos = 0;
+		while (pos < len) {
+			/** whole block in chunk, no stage */
+			if (codec->m_size == 0 && len - pos >= codec::c_block) {
+				codec->flush(data + pos, codec::c_block);
+				pos += codec::c_block;
+				continue;
+			}
+			length_t size = std::min(len - pos, codec::c_block - codec->m_size);
+			memcpy(&codec->m_block[codec->m_size], data + pos, size);
+			codec->m_size += size;
+			pos += size;
+
+			if (codec->m_size == codec::c_block) {
+				codec->flush(&codec->m_block[0], codec->m_size);
+				codec->m_size = 0;
+			}
+		}
+		return len;
+	}
+
+	length_t
+	Codec::compress(const BaseBuffer& src, DynBuffer& dst, uint32_t* crc, length_t len)
+	{
+		m_block.resize(codec::c_block);
+		m_size = 0;
+		m_dst = &dst;
+		m_crc = crc;
+		m_total = 0;
+
+		src.dispatch(compress_handle, this, len);
+		if (m_size > 0) {
+			flush(&m_block[0], m_size);
+			m_size = 0;
+		}
+		m_dst = NULL;
+		m_crc = NULL;
+		return m_total;
+	}
+
+	length_t
+	Codec::decompress(const BaseBuffer& src, DynBuffer& dst)
+	{
+		length_t total = 0;
+		length_t off = 0;
+		m_block.resize(codec::c_block);
+
+		while (off < src.length()) {
+			uint32_t head = 0;
+			if (src.length() - off < (length_t)sizeof(head)) {
+				return -1;
+			}
+			src.peek(&head, sizeof(head), off);
+			off += sizeof(head);
+
+			length_t size = head & ~codec::c_stored;
+			if (size > bound(codec::c_block) || src.length() - off < size) {
+				return -1;
+			}
+			m_output.resize(size);
+			src.peek(&m_output[0], size, off);
+			off += size;
+
+			if (head & codec::c_stored) {
+				dst.write(&m_output[0], size);
+
+			} else {
+				length_t len = decode(&m_output[0], size, &m_block[0], codec::c_block);
+				if (len < 0) {
+					return -1;
+				}
+				size = len;
+				dst.write(&m_block[0], size);
+			}
+			total += size;
+		}
+		return total;
+	}
+
+	length_t
+	LzCodec::encode(const byte_t* src, length_t len, byte_t* dst, length_t cap)
+	{
+		const byte_t* ip = src;
+		const byte_t* anchor = src;
+		const byte_t* end = src + len;
+		const byte_t* limit = len > c_match_limit ? end - c_match_limit : src;
+		const byte_t* match_end = end - c_last_literal;
+		byte_t* op = dst;
+		byte_t* op_end = dst + cap;
+
+		memset(m_table, 0, sizeof(m_table));
+		while (ip < limit) {
+			uint32_t sequence = read32(ip);
+			uint32_t hash = (sequence * 2654435761U) >> (32 - c_hash_bit);
+			const byte_t* ref = src + m_table[hash];
+			m_table[hash] = (uint32_t)(ip - src);
+
+			if (ref >= ip || ip - ref > 0xFFFF || read32(ref) != sequence) {
+				/** skip faster when no match for long */
+				ip += 1 + ((ip - anchor) >> 6);
+				continue;
+			}
+
+			/** extend match 8 byte each time */
+			const byte_t* mp = ip + c_match_min;
+			const byte_t* rp = ref + c_match_min;
+			while (mp + 8 <= match_end) {
+				uint64_t diff = read64(mp) ^ read64(rp);
+				if (diff) {
+					mp += __builtin_ctzll(diff) >> 3;
+					break;
+				}
+				mp += 8;
+				rp += 8;
+			}
+			if (mp + 8 > match_end) {
+				while (mp < match_end && *mp == *rp) {
+					mp++;
+					rp++;
+				}
+			}
+
+			length_t literal = ip - anchor;
+			length_t match = mp - ip - c_match_min;
+			if (op + 1 + literal + literal / 255 + 2 + match / 255 + 2 > op_end) {
+				return 0;
+			}
+
+			byte_t* token = op++;
+			*token = (byte_t)(std::min(literal, 15) << 4);
+			if (literal >= 15) {
+				length_t remain = literal - 15;
+				for (; remain >= 255; remain -= 255) {
+					*op++ = (byte_t)255;
+				}
+				*op++ = (byte_t)remain;
+			}
+			memcpy(op, anchor, literal);
+			op += literal;
+
+			uint16_t offset = (uint16_t)(ip - ref);
+			memcpy(op, &offset, sizeof(offset));
+			op += sizeof(offset);
+
+			*token |= (byte_t)std::min(match, 15);
+			if (match >= 15) {
+				length_t remain = match - 15;
+				for (; remain >= 255; remain -= 255) {
+					*op++ = (byte_t)255;
+				}
+				*op++ = (byte_t)remain;
+			}
+			ip = mp;
+			anchor = mp;
+		}
+
+		/** last literal */
+		length_t literal = end - anchor;
+		if (op + 1 + literal + literal / 255 + 1 > op_end) {
+			return 0;
+		}
+		byte_t* token = op++;
+		*token = (byte_t)(std::min(literal, 15) << 4);
+		if (literal >= 15) {
+			length_t remain = literal - 15;
+			for (; remain >= 255; remain -= 255) {
+				*op++ = (byte_t)255;
+			}
+			*op++ = (byte_t)remain;
+		}
+		memcpy(op, anchor, literal);
+		op += literal;
+		return op - dst;
+	}
+
+	length_t
+	LzCodec::decode(const byte_t* src, length_t len, byte_t* dst, length_t cap)
+	{
+		const uint8_t* ip = (const uint8_t*)src;
+		const uint8_t* end = ip + len;
+		byte_t* op = dst;
+		byte_t* op_end = dst + cap;
+
+		while (ip < end) {
+			uint8_t token = *ip++;
+			length_t literal = token >> 4;
+			if (literal == 15) {
+				uint8_t value = 255;
+				while (value == 255 && ip < end) {
+					value = *ip++;
+					literal += value;
+				}
+			}
+			if (literal > end - ip || literal > op_end - op) {
+				return -1;
+			}
+			memcpy(op, ip, literal);
+			ip += literal;
+			op += literal;
+
+			/** last sequence, literal only */
+			if (ip == end) {
+				break;
+
+			} else if (end - ip < 2) {
+				return -1;
+			}
+			length_t offset = ip[0] | (ip[1] << 8);
+			ip += 2;
+
+			length_t match = token & 15;
+			if (match == 15) {
+				uint8_t value = 255;
+				while (value == 255 && ip < end) {
+					value = *ip++;
+					match += value;
+				}
+			}
+			match += c_match_min;
+			if (offset == 0 || offset > op - dst || match > op_end - op) {
+				return -1;
+			}
+
+			/** match may overlap output */
+			const byte_t* ref = op - offset;
+			if (offset >= match) {
+				memcpy(op, ref, match);
+			} else {
+				for (length_t i = 0; i < match; i++) {
+					op[i] = ref[i];
+				}
+			}
+			op += match;
+		}
+		return op - dst;
+	}
+
+#if USING_ZSTD
+	/**
+	 * @brief zstd codec, context kept
+	 **/
+	class ZstdCodec : public Codec
+	{
+	public:
+		ZstdCodec(int level = 1) : m_level(level) {
+			m_cctx = ZSTD_createCCtx();
+			m_dctx = ZSTD_createDCtx();
+		}
+
+		virtual ~ZstdCodec() {
+			ZSTD_freeCCtx(m_cctx);
+			ZSTD_freeDCtx(m_dctx);
+		}
+
+	public:
+		virtual int type() const { return codec::CT_zstd; }
+
+		virtual const char* name() const { return "zstd"; }
+
+		virtual length_t bound(length_t len) const { return ZSTD_compressBound(len); }
+
+		virtual length_t encode(const byte_t* src, length_t len, byte_t* dst, length_t cap) {
+			size_t size = ZSTD_compressCCtx(m_cctx, dst, cap, src, len, m_level);
+			return ZSTD_isError(size) ? 0 : (length_t)size;
+		}
+
+		virtual length_t decode(const byte_t* src, length_t len, byte_t* dst, length_t cap) {
+			size_t size = ZSTD_decompressDCtx(m_dctx, dst, cap, src, len);
+			return ZSTD_isError(size) ? -1 : (length_t)size;
+		}
+
+	protected:
+		/** compress level */
+		int			m_level = { 1 };
+		ZSTD_CCtx*	m_cctx = { NULL };
+		ZSTD_DCtx*	m_dctx = { NULL };
+	};
+#endif
+
+#if USING_LZ4
+	/**
+	 * @brief lz4 block codec
+	 **/
+	class Lz4Codec : public Codec
+	{
+	public:
+		virtual int type() const { return codec::CT_lz4; }
+
+		virtual const char* name() const { return "lz4"; }
+
+		virtual length_t bound(length_t len) const { return LZ4_compressBound(len); }
+
+		virtual length_t encode(const byte_t* src, length_t len, byte_t* dst, length_t cap) {
+			return LZ4_compress_default(src, dst, len, cap);
+		}
+
+		virtual length_t decode(const byte_t* src, length_t len, byte_t* dst, length_t cap) {
+			int size = LZ4_decompress_safe(src, dst, len, cap);
+			return size < 0 ? -1 : size;
+		}
+	};
+#endif
+
+	Codec*
+	Codec::create(int type)
+	{
+		switch (type) {
+		case codec::CT_lz:
+			return new LzCodec;
+	#if USING_ZSTD
+		case codec::CT_zstd:
+			return new ZstdCodec;
+	#endif
+	#if USING_LZ4
+		case codec::CT_lz4:
+			return new Lz4Codec;
+	#endif
+		default:
+			return NULL;
+		}
+	}
+}
+
+#if COMMON_TEST
+#include <string>
+#include "Common/LogHelper.hpp"
+#include "Common/Display.hpp"
+#include "Advance/Hash.hpp"
+#include "Perform/Timer.hpp"
+
+namespace common {
+namespace tester {
+
+	/**
+	 * log like text, field repeated with random number
+	 **/
+	std::string
+	__codec_text(length_t len)
+	{
+		static const char* s_level[] = { "INFO", "WARN", "DEBUG", "ERROR" };
+		std::string data;
+		char line[256];
+		for (int i = 0; data.length() < (size_t)len; i++) {
+			snprintf(line, sizeof(line), "[10-18-26 00:%02d:%02d.%06d] %s - {\"object\": \"key_%d\", \"size\": %d, "
+				"\"unit\": %d, \"status\": \"done\"}\n", i / 60 % 60, i % 60, rand() % 1000000,
+				s_level[rand() % 4], rand() % 100000, rand() % 65536, i / 100);
+			data += line;
+		}
+		data.resize(len);
+		return data;
+	}
+
+	void
+	__codec_check(Codec* codec, const std::string& origin, length_t piece)
+	{
+		DynBuffer source;
+		for (length_t pos = 0; pos < (length_t)origin.length(); pos += piece) {
+			source.write(origin.data() + pos, std::min(piece, (length_t)origin.length() - pos));
+		}
+		DynBuffer packed;
+		uint32_t crc = 0;
+		length_t size = codec->compress(source, packed, &crc);
+		success(size == packed.length() && crc == crc32c(packed));
+
+		DynBuffer output;
+		success(codec->decompress(packed, output) == (length_t)origin.length());
+		std::string data(origin.length(), 0);
+		output.peek(&data[0], output.length());
+		success(data == origin);
+	}
+
+	void
+	codec_test()
+	{
+		LzCodec lz;
+		byte_t packed[1024];
+		byte_t output[1024];
+
+		/** short data, all literal */
+		for (length_t len = 0; len < 40; len++) {
+			std::string origin = __codec_text(len);
+			length_t size = lz.encode(origin.data(), len, packed, lz.bound(len));
+			success(size > 0 && lz.decode(packed, size, output, sizeof(output)) == len);
+			success(memcmp(output, origin.data(), len) == 0);
+		}
+
+		/** overlap match, long literal and match length */
+		std::string repeat(1000, 'a');
+		length_t size = lz.encode(repeat.data(), 1000, packed, lz.bound(1000));
+		success(size < 20 && lz.decode(packed, size, output, sizeof(output)) == 1000);
+		success(memcmp(output, repeat.data(), 1000) == 0);
+
+		/** broken data or output not enough */
+		success(lz.decode(packed, size, output, 999) == -1);
+		success(lz.decode(packed, size - 1, output, sizeof(output)) == -1);
+		success(lz.encode(repeat.data(), 1000, packed, 4) == 0);
+
+		/** random data stored raw */
+		std::string random(c_length_64K * 2 + 100, 0);
+		for (auto& c : random) {
+			c = (char)rand();
+		}
+		__codec_check(&lz, random, 5000);
+		success(Codec::create(codec::CT_none) == NULL);
+
+		std::string text = __codec_text(c_length_1M * 4 + 123);
+		for (int type = codec::CT_lz; type <= codec::CT_lz4; type++) {
+			Codec* codec = Codec::create(type);
+			if (!codec) {
+				continue;
+			}
+			__codec_check(codec, text, 1000);
+			__codec_check(codec, text, DynBuffer::c_length);
+
+			/** only head part */
+			DynBuffer part;
+			part.write(text.data(), c_length_1M);
+			DynBuffer head;
+			success(codec->compress(part, head, NULL, 100000) > 0);
+			part.clear();
+			success(codec->decompress(head, part) == 100000);
+
+			DynBuffer source;
+			source.write(text.data(), text.length());
+			DynBuffer packed;
+			DynBuffer output;
+			CREATE_TIMER;
+			for (int i = 0; i < 10; i++) {
+				packed.clear();
+				codec->compress(source, packed);
+			}
+			ctime_t encode = timer.check();
+			for (int i = 0; i < 10; i++) {
+				output.clear();
+				codec->decompress(packed, output);
+			}
+			ctime_t decode = timer.check();
+			log_info("codec " << codec->name() << ", ratio " << (double)text.length() / packed.length()
+				<< ", compress " << string_speed((int64_t)10 * text.length(), encode)
+				<< ", decompress " << string_speed((int64_t)10 * text.length(), decode));
+			delete codec;
+		}
+	}
+}
+}
+#endif
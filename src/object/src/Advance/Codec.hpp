@@ -0,0 +1,156 @@
+
+#pragma once
+
+#include <vector>
+
+#include "Common/Type.hpp"
+#include "Advance/BaseBuffer.hpp"
+
+namespace common
+{
+	class DynBuffer;
+
+	namespace codec {
+		/**
+		 * codec type recorded on disk
+		 **/
+		enum Type {
+			CT_none = 0,
+			/** built in lz77 */
+			CT_lz,
+			/** build with USING_ZSTD */
+			CT_zstd,
+			/** build with USING_LZ4 */
+			CT_lz4,
+		};
+		/** buffer compressed block by block, block independent */
+		static const length_t c_block = c_length_64K;
+		/** block header flag, block stored raw */
+		static const uint32_t c_stored = 0x80000000;
+	}
+
+	/**
+	 * @brief compress codec, block interface and buffer stream
+	 * @note codec keep context and stage buffer, not thread safe, one
+	 * codec each thread
+	 */
+	class Codec
+	{
+	public:
+		virtual ~Codec() {}
+
+	public:
+		/**
+		 * @brief codec type
+		 **/
+		virtual int type() const = 0;
+
+		/**
+		 * @brief codec name
+		 **/
+		virtual const char* name() const = 0;
+
+		/**
+		 * @brief max encoded length of len
+		 **/
+		virtual length_t bound(length_t len) const = 0;
+
+		/**
+		 * @brief compress block
+		 * @return encoded length, 0 if cap not enough or failed
+		 **/
+		virtual length_t encode(const byte_t* src, length_t len, byte_t* dst, length_t cap) = 0;
+
+		/**
+		 * @brief decompress block
+		 * @return decoded length, -1 if data broken or cap not enough
+		 **/
+		virtual length_t decode(const byte_t* src, length_t len, byte_t* dst, length_t cap) = 0;
+
+	public:
+		/**
+		 * @brief compress buffer block by block, chunk data used in place
+		 * when block not span chunk
+		 * @param dst output buffer, append to
+		 * @param crc if set, chain crc32c of output while writing
+		 * @param len source length
+		 * @return output length
+		 * @note each block with 4 byte header, encoded length, or raw length
+		 * with c_stored flag if not compressible
+		 **/
+		length_t	compress(const BaseBuffer& src, DynBuffer& dst, uint32_t* crc = NULL,
+						length_t len = BaseBuffer::c_invalid_length);
+
+		/**
+		 * @brief decompress buffer made by compress
+		 * @param dst output buffer, append to
+		 * @return output length, -1 if data broken
+		 **/
+		length_t	decompress(const BaseBuffer& src, DynBuffer& dst);
+
+	public:
+		/**
+		 * @brief create codec, NULL if type not built
+		 **/
+		static Codec* create(int type);
+
+	protected:
+		/**
+		 * @brief compress one block and append to output
+		 **/
+		void		flush(const byte_t* data, length_t len);
+
+		/**
+		 * @brief dispatch handle of compress
+		 **/
+		static length_t	compress_handle(void* ptr, const byte_t* data, length_t len);
+
+	protected:
+		/** block not full */
+		std::vector<byte_t> m_block;
+		/** encode output */
+		std::vector<byte_t> m_output;
+		/** block data length */
+		length_t	m_size = { 0 };
+		/** current output */
+		DynBuffer*	m_dst = { NULL };
+		/** current output crc */
+		uint32_t*	m_crc = { NULL };
+		/** current output length */
+		length_t	m_total = { 0 };
+	};
+
+	/**
+	 * @brief lz77 codec, lz4 like sequence, 4K hash table, 64K window
+	 **/
+	class LzCodec : public Codec
+	{
+	public:
+		virtual int type() const { return codec::CT_lz; }
+
+		virtual const char* name() const { return "lz"; }
+
+		virtual length_t bound(length_t len) const { return len + len / 255 + 16; }
+
+		virtual length_t encode(const byte_t* src, length_t len, byte_t* dst, length_t cap);
+
+		virtual length_t decode(const byte_t* src, length_t len, byte_t* dst, length_t cap);
+
+	protected:
+		/** hash table size, in bit */
+		static const int c_hash_bit = 12;
+		/** data at end always literal */
+		static const int c_last_literal = 5;
+		/** no match start near end */
+		static const int c_match_limit = 12;
+		/** min match length */
+		static const int c_match_min = 4;
+
+		/** position of last sequence with same hash */
+		uint32_t	m_table[1 << c_hash_bit];
+	};
+}
+
+#if COMMON_SPACE
+	using common::Codec;
+#endif
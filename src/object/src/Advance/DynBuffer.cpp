@@ -1,8 +1,11 @@
 
 #include <cstring>
+#include <sys/uio.h>
 
+#include "Common/Atomic.hpp"
 #include "Advance/DynBuffer.hpp"
 #include "Advance/DynChunk.hpp"
+#include "Advance/Hash.hpp"
 #include "Advance/MemPool.hpp"
 
 namespace common {
@@ -13,13 +16,31 @@ MemConfig& chunk_config(MemConfig& config) {
 	return config;
 }
 
+/** dyn chunk churn across threads, keep thread magazine */
+static MemConfig&
+dyn_chunk_config() {
+	static MemConfig s_config(DynBuffer::c_length);
+	s_config.magazine = memory::c_magazine_len;
+	s_config.account = account::AT_buffer;
+	return chunk_config(s_config);
+}
+
 static BaseAlloter*
 dyn_chunk_pool() {
-	static MemConfig s_config(DynBuffer::c_length);
-	static MemPool s_dyn_chunk_pool(chunk_config(s_config));
+	static MemPool s_dyn_chunk_pool(dyn_chunk_config());
 	return &s_dyn_chunk_pool;
 }
 
+/** chunk view hold no storage, only chunk struct */
+static BaseAlloter*
+ref_chunk_pool() {
+	static MemConfig s_config(sizeof(DynBuffer::Chunk));
+	s_config.magazine = memory::c_magazine_len;
+	s_config.account = account::AT_buffer;
+	static MemPool s_ref_chunk_pool(s_config);
+	return &s_ref_chunk_pool;
+}
+
 void
 dyn_chunk_pool(length_t piece, length_t align) {
 	MemPool* pool = (MemPool*)dyn_chunk_pool();
@@ -36,7 +57,7 @@ DynBuffer::Chunk::_new(void* data)
 length_t
 DynBuffer::Chunk::total() const
 {
-	return mem_piece(this);
+	return mem_piece(share ? share : this);
 }
 
 void
@@ -75,17 +96,52 @@ DynBuffer::append_chunk(Chunk* chunk)
 	return chunk;
 }
 
-length_t
-DynBuffer::dispatch(data_handle_t handle, void* ptr, length_t len, length_t off) const
+DynBuffer::Chunk*
+DynBuffer::locate(length_t& off, Cursor* cursor) const
 {
 	Chunk* cur = m_head;
-	while (off && cur) {
-		if (cur->length() > off) {
-			break;
-		}
-		off -= cur->length();
+	length_t pos = 0;
+	/** seek forward from last located chunk */
+	if (cursor && cursor->chunk && off >= cursor->pos) {
+		cur = cursor->chunk;
+		pos = cursor->pos;
+	}
+	while (cur && pos + cur->length() <= off) {
+		pos += cur->length();
 		cur = cur->next;
 	}
+	if (cursor && cur) {
+		cursor->chunk = cur;
+		cursor->pos = pos;
+	}
+	off -= pos;
+	return cur;
+}
+
+length_t
+DynBuffer::dispatch(data_handle_t handle, void* ptr, length_t len, length_t off) const
+{
+	Cursor cursor;
+	return dispatch(cursor, handle, ptr, len, off);
+}
+
+length_t
+DynBuffer::peek(Cursor& cursor, void* data, length_t len, length_t off) const
+{
+	static auto handle = [](void* ptr, const byte_t* data, length_t len) {
+		byte_t** pos = (byte_t**)ptr;
+		memcpy(*pos, data, len);
+		*pos += len;
+		return len;
+	};
+	byte_t* pos = (byte_t*)data;
+	return dispatch(cursor, handle, &pos, len, off);
+}
+
+length_t
+DynBuffer::dispatch(Cursor& cursor, data_handle_t handle, void* ptr, length_t len, length_t off) const
+{
+	Chunk* cur = locate(off, &cursor);
 	//off maybe remain sth, it will set to 0 in the first loop
 	length_t pos = 0;
 	length_t ret = 0;
@@ -103,6 +159,42 @@ DynBuffer::dispatch(data_handle_t handle, void* ptr, length_t len, length_t off)
 	return pos;
 }
 
+int
+DynBuffer::to_iovec(struct iovec* iov, int count, length_t len, length_t off) const
+{
+	Chunk* cur = locate(off);
+	int index = 0;
+	length_t pos = 0;
+	while (pos < len && cur && index < count) {
+		length_t rd = std::min(cur->length() - off, len - pos);
+		if (rd > 0) {
+			iov[index].iov_base = cur->rpos() + off;
+			iov[index].iov_len = rd;
+			index++;
+		}
+		pos += rd;
+		off = 0;
+		cur = cur->next;
+	}
+	return index;
+}
+
+int
+DynBuffer::iovec_count(length_t len, length_t off) const
+{
+	Chunk* cur = locate(off);
+	int count = 0;
+	length_t pos = 0;
+	while (pos < len && cur) {
+		length_t rd = std::min(cur->length() - off, len - pos);
+		count += (rd > 0 ? 1 : 0);
+		pos += rd;
+		off = 0;
+		cur = cur->next;
+	}
+	return count;
+}
+
 length_t
 DynBuffer::write(const void* data, length_t len)
 {
@@ -110,9 +202,8 @@ DynBuffer::write(const void* data, length_t len)
 	length_t pos = 0;
 	while (pos < len) {
 		if (!cur && !(cur = append_chunk())) {
-			//fault_format("can't alloc more buffer ");
-			assert(0);
-			return 0;
+			/** memory governor refuse, keep what written */
+			break;
 		}
 		length_t wt = std::min(len - pos, cur->remain());
 		memcpy(cur->wpos(), (const char*)data + pos, wt);
@@ -124,6 +215,25 @@ DynBuffer::write(const void* data, length_t len)
 	return pos;
 }
 
+length_t
+DynBuffer::write(const void* data, length_t len, uint32_t& crc)
+{
+	Chunk* cur = m_tail;
+	length_t pos = 0;
+	while (pos < len) {
+		if (!cur && !(cur = append_chunk())) {
+			break;
+		}
+		length_t wt = std::min(len - pos, cur->remain());
+		crc = crc32c_copy(cur->wpos(), (const char*)data + pos, wt, crc);
+		cur->inc(wt);
+		pos += wt;
+		cur = cur->next;
+	}
+	inc(pos);
+	return pos;
+}
+
 length_t
 DynBuffer::remove(length_t len)
 {
@@ -205,14 +315,109 @@ DynBuffer::alloter()
 DynBuffer::Chunk*
 DynBuffer::new_chunk()
 {
-	Chunk* chunk = (Chunk*)alloter()->_new();
-	return Chunk::_new(chunk);
+	BaseAlloter* alloter = this->alloter();
+	void* data = alloter->_new();
+	if (!data) {
+		return NULL;
+	}
+	Chunk* chunk = Chunk::_new(data);
+	chunk->alloter = alloter;
+	return chunk;
 }
 
 void
 DynBuffer::del_chunk(Chunk* chunk)
 {
-	alloter()->_del(chunk);
+	Chunk* storage = chunk->storage();
+	if (chunk != storage) {
+		ref_chunk_pool()->_del(chunk);
+	}
+	/** storage chunk itself may already leave its dyn, but not freed */
+	if (atomic_add64(&storage->ref, -1) == 1) {
+		storage->alloter->_del(storage);
+	}
+}
+
+DynBuffer::Chunk*
+DynBuffer::share_chunk(Chunk* chunk, length_t off, length_t len)
+{
+	void* data = ref_chunk_pool()->_new();
+	if (!data) {
+		return NULL;
+	}
+	Chunk* storage = chunk->storage();
+	at_inc64(storage->ref);
+
+	Chunk* view = ::new(data) Chunk(storage->data);
+	view->share = storage;
+	view->beg = chunk->beg + off;
+	view->end = view->beg + len;
+	return view;
+}
+
+length_t
+DynBuffer::share(const DynBuffer* dyn, length_t len, length_t off)
+{
+	Chunk* cur = dyn->locate(off);
+	length_t pos = 0;
+	while (pos < len && cur) {
+		length_t rd = std::min(cur->length() - off, len - pos);
+		if (rd > 0) {
+			Chunk* view = share_chunk(cur, off, rd);
+			if (!view) {
+				break;
+			}
+			append_chunk(view);
+		}
+		pos += rd;
+		off = 0;
+		cur = cur->next;
+	}
+	return pos;
+}
+
+DynBuffer
+DynBuffer::split(length_t off)
+{
+	DynBuffer dyn(m_alloter);
+	if (off >= length()) {
+		return dyn;
+	}
+
+	Chunk* cur = m_head, *last = NULL;
+	length_t pos = 0;
+	while (pos + cur->length() <= off) {
+		pos += cur->length();
+		last = cur;
+		cur = cur->next;
+	}
+
+	/** chunk across off, tail part go to new dyn as view */
+	if (pos < off) {
+		length_t keep = off - pos;
+		Chunk* view = share_chunk(cur, keep, cur->length() - keep);
+		if (!view) {
+			return dyn;
+		}
+		view->next = cur->next;
+		cur->retrieve(cur->length() - keep);
+		cur->next = NULL;
+		last = cur;
+		cur = view;
+	}
+
+	dyn.m_head = cur;
+	dyn.m_tail = (m_tail == last) ? cur : m_tail;
+	dyn.length(length() - off);
+
+	if (last) {
+		last->next = NULL;
+	} else {
+		m_head = NULL;
+	}
+	m_tail = last;
+	length(off);
+	return dyn;
 }
 
 void
@@ -231,7 +436,7 @@ DynBuffer::clear()
 void
 DynBuffer::adjust()
 {
-	if (m_head) {
+	if (m_head && !m_head->shared()) {
 		m_head->adjust();
 	}
 }
@@ -239,15 +444,8 @@ DynBuffer::adjust()
 char 
 DynBuffer::operator[] (length_t pos) const
 {
-	Chunk* cur = m_head;
-	while (cur) {
-		if (cur->length() > pos) {
-			return *(cur->rpos() + pos);
-		}
-		pos -= cur->length();
-		cur  = cur->next;
-	}
-	return -1;
+	Chunk* cur = locate(pos);
+	return cur ? *(cur->rpos() + pos) : -1;
 }
 
 //length_t
@@ -322,11 +520,16 @@ DynBuffer::append(DynBuffer* dyn, length_t len)
 			m_tail->next = NULL;
 		}
 
-		//append tail
+		inc(pos);
+
+		//append tail, share part of chunk
 		if (pos < len) {
 			len = len - pos;
-			Chunk* chunk = append_chunk();
-			chunk->assign(cur, len);
+			Chunk* view = share_chunk(cur, 0, len);
+			if (!view) {
+				return pos;
+			}
+			append_chunk(view);
 			cur->dec(len);
 			dyn->dec(len);
 			pos += len;
@@ -334,7 +537,6 @@ DynBuffer::append(DynBuffer* dyn, length_t len)
 		if (!dyn->m_head) {
 			dyn->m_tail = NULL;
 		}
-		inc(pos);
 		return pos;
 	}
 }	
@@ -360,7 +562,10 @@ DynBuffer::check()
 #include <unistd.h>
 #include "Common/Logger.hpp"
 #include "Common/Display.hpp"
+#include "Common/File.hpp"
+#include "Common/Util.hpp"
 #include "Advance/BufferStream.hpp"
+#include "Perform/Timer.hpp"
 
 using namespace common;
 using std::string;
@@ -465,6 +670,237 @@ namespace tester {
 		}
 		ba.clear();
 	}
+
+	length_t
+	__iovec_write(void* ptr, const byte_t* data, length_t len)
+	{
+		return ((FileBase*)ptr)->write(data, len);
+	}
+
+	void
+	dyn_iovec_test()
+	{
+		const length_t total = c_length_1M + 1000;
+		std::string origin;
+		DynBuffer buffer;
+		while ((length_t)origin.length() < total) {
+			std::string part(std::min(total - (length_t)origin.length(), (length_t)(rand() % 5000 + 1)),
+				(char)('a' + origin.length() % 26));
+			buffer.write(part.data(), part.length());
+			origin += part;
+		}
+
+		/** window export match origin data */
+		struct iovec iov[64];
+		length_t window[][2] = { { 0, total }, { 100, 70000 }, { DynBuffer::c_length, DynBuffer::c_length },
+			{ total - 10, 100 }, { total, 10 } };
+		for (auto& w : window) {
+			int count = buffer.to_iovec(iov, 64, w[1], w[0]);
+			success(count == buffer.iovec_count(w[1], w[0]));
+			std::string data;
+			for (int i = 0; i < count; i++) {
+				data.append((char*)iov[i].iov_base, iov[i].iov_len);
+			}
+			success(data == origin.substr(w[0], w[1]));
+		}
+
+		/** object head and data, write one by one or in one vector */
+		const std::string path = "/tmp/dyn_iovec_test";
+		byte_t head[512] = {};
+		FileBase file;
+		success(file.open(path, make_bit(FileBase::op_creat, FileBase::op_write, FileBase::op_trunc)) == 0);
+
+		const int loop = 200;
+		for (int vector = 0; vector < 2; vector++) {
+			int64_t calls = 0;
+			file.trunc(0);
+			file.seek(0);
+
+			CREATE_TIMER;
+			for (int i = 0; i < loop; i++) {
+				if (vector) {
+					iov[0].iov_base = head;
+					iov[0].iov_len = sizeof(head);
+					int count = buffer.to_iovec(iov + 1, 63) + 1;
+					success(file.writev(iov, count) == (int64_t)sizeof(head) + total);
+					calls++;
+
+				} else {
+					success(file.write(head, sizeof(head)) == sizeof(head));
+					success(buffer.dispatch(__iovec_write, &file) == total);
+					calls += 1 + buffer.iovec_count();
+				}
+			}
+			ctime_t time = timer.check();
+			log_info("object write, " << (vector ? "writev  " : "one by one") << ", syscall " << calls / loop
+				<< " per object, speed " << string_speed((int64_t)loop * total, time));
+		}
+
+		/** read back last object in one vector */
+		std::string data(total, 0);
+		iov[0].iov_base = head;
+		iov[0].iov_len = sizeof(head);
+		iov[1].iov_base = &data[0];
+		iov[1].iov_len = total;
+		success(file.preadv(iov, 2, (int64_t)(loop - 1) * (sizeof(head) + total)) == (int64_t)sizeof(head) + total);
+		success(data == origin);
+
+		file.close();
+		file_rm(path);
+	}
+
+	std::string
+	__dyn_string(const DynBuffer& buffer)
+	{
+		std::string data(buffer.length(), 0);
+		const_cast<DynBuffer&>(buffer).peek(&data[0], buffer.length());
+		return data;
+	}
+
+	void
+	dyn_share_test()
+	{
+		const length_t total = c_length_1M * 4 + 1000;
+		std::string origin(total, 0);
+		for (length_t i = 0; i < total; i++) {
+			origin[i] = 'a' + i % 26;
+		}
+
+		do {
+			DynBuffer buffer;
+			buffer.write(origin.data(), total);
+
+			/** slice and clone share storage, writer never touch shared part */
+			DynBuffer slice = buffer.slice(DynBuffer::c_length - 10, 100);
+			DynBuffer clone = buffer.clone();
+			DynBuffer copy = buffer;
+			success(__dyn_string(slice) == origin.substr(DynBuffer::c_length - 10, 100));
+			success(__dyn_string(clone) == origin && __dyn_string(copy) == origin);
+			success(clone.tail()->shared() && buffer.tail()->shared());
+			success(!copy.head()->shared() && !copy.tail()->shared());
+
+			buffer.write("0123456789", 10);
+			clone.write("abcdefghij", 10);
+			success(__dyn_string(buffer) == origin + "0123456789");
+			success(__dyn_string(clone) == origin + "abcdefghij");
+			success(__dyn_string(copy) == origin);
+
+			/** split at chunk middle and chunk boundary */
+			length_t points[] = { total / 2 + 7, DynBuffer::c_length, 0 };
+			for (auto off : points) {
+				DynBuffer left = copy.clone();
+				DynBuffer right = left.split(off);
+				left.check();
+				right.check();
+				success(__dyn_string(left) == origin.substr(0, off));
+				success(__dyn_string(right) == origin.substr(off));
+				left.write("x", 1);
+				success(__dyn_string(right) == origin.substr(off));
+			}
+
+			/** partial append share tail chunk */
+			DynBuffer part;
+			DynBuffer source = copy.clone();
+			part.append(&source, 1000);
+			part.append(std::move(source));
+			success(source.length() == 0 && __dyn_string(part) == origin);
+
+			buffer.clear();
+			copy.clear();
+			success(__dyn_string(clone) == origin + "abcdefghij");
+			success(__dyn_string(slice) == origin.substr(DynBuffer::c_length - 10, 100));
+		} while (0);
+
+		/** replicate payload, copy each or share */
+		DynBuffer buffer;
+		buffer.write(origin.data(), total);
+		const int loop = 1000;
+		for (int share = 0; share < 2; share++) {
+			CREATE_TIMER;
+			for (int i = 0; i < loop; i++) {
+				DynBuffer replica;
+				if (share) {
+					replica = buffer.clone();
+				} else {
+					replica.copy(&buffer);
+				}
+			}
+			ctime_t time = timer.check();
+			log_info("replicate " << string_size(total) << ", " << (share ? "share" : "copy ")
+				<< ", " << string_iops(loop, time) << " ops/s");
+		}
+	}
+
+	void
+	dyn_seek_test()
+	{
+		const length_t total = c_length_1M * 64;
+		DynBuffer buffer;
+		uint32_t value = 0;
+		for (length_t i = 0; i < total / (length_t)sizeof(value); i++) {
+			value = i;
+			buffer.write(&value, sizeof(value));
+		}
+
+		/** random peek, mixed with remove and split */
+		for (int i = 0; i < 10000; i++) {
+			length_t index = rand() % (buffer.length() / sizeof(value));
+			success(buffer.peek(&value, sizeof(value), index * sizeof(value)) == sizeof(value));
+			success(value == (uint32_t)index + (uint32_t)(total - buffer.length()) / sizeof(value));
+			if (i % 1000 == 999) {
+				buffer.remove(rand() % 100 * sizeof(value));
+			}
+		}
+		length_t origin = (total - buffer.length()) / sizeof(value);
+		DynBuffer tail = buffer.split(buffer.length() / 8 * sizeof(value) + 4);
+		tail.peek(&value, sizeof(value), 4);
+		success(value == origin + buffer.length() / sizeof(value) + 1);
+		success(buffer[buffer.length()] == -1 && tail[tail.length()] == -1);
+		buffer.append(std::move(tail));
+
+		/** cursor move forward, and reset after remove */
+		DynBuffer::Cursor cursor;
+		length_t index = buffer.length() / sizeof(value) / 2;
+		success(buffer.peek(cursor, &value, sizeof(value), index * sizeof(value)) == sizeof(value));
+		success(value == origin + index && cursor.chunk != NULL);
+		success(buffer.peek(cursor, &value, sizeof(value), 0) == sizeof(value) && value == origin);
+		buffer.remove(DynBuffer::c_length * 2);
+		cursor.reset();
+		success(buffer.peek(cursor, &value, sizeof(value), 0) == sizeof(value));
+		success(value == origin + DynBuffer::c_length * 2 / sizeof(value));
+
+		/** parse in small reads, forward from cursor or each from head */
+		buffer.clear();
+		for (length_t i = 0; i < total / (length_t)sizeof(value); i++) {
+			value = i;
+			buffer.write(&value, sizeof(value));
+		}
+		const length_t step = 16;
+		byte_t data[step];
+		do {
+			DynBuffer::Cursor cursor;
+			CREATE_TIMER;
+			for (length_t off = 0; off < total; off += step) {
+				buffer.peek(cursor, data, step, off);
+			}
+			ctime_t time = timer.check();
+			success(*(uint32_t*)data == (uint32_t)(total - step) / sizeof(value));
+			log_info("parse " << string_size(total) << ", forward   " << string_iops(total / step, time)
+				<< " ops/s, speed " << string_speed(total, time));
+		} while (0);
+
+		do {
+			/** no cursor, each read walk from head */
+			const length_t part = total / 256;
+			CREATE_TIMER;
+			for (length_t off = total / 2; off < total / 2 + part; off += step) {
+				buffer.peek(data, step, off);
+			}
+			ctime_t time = timer.check();
+			log_info("parse " << string_size(part) << ", from head " << string_iops(part / step, time)
+				<< " ops/s, speed " << string_speed(part, time));
+		} while (0);
+	}
 }
 }
 #endif
@@ -1,9 +1,13 @@
 
 #pragma once
 
+#include <utility>
+
 #include "Common/Const.hpp"
 #include "Advance/BaseBuffer.hpp"
 
+struct iovec;
+
 namespace common {
 
 	class BaseAlloter;
@@ -44,26 +48,77 @@ namespace common {
 
 		/** 
 		 * @brief = operator, copy existing data
+		 * @note use clone() to share data without copy
 		 */
 		const DynBuffer& operator = (const DynBuffer& v) {
 			if (this != &v) {
 				clear();
+				m_alloter = v.m_alloter;
 				copy(const_cast<DynBuffer*>(&v));
+			}
+			return *this;
+		}
+
+		/** 
+		 * @brief move constructor
+		 */
+		DynBuffer(DynBuffer&& v) {
+			operator = (std::move(v));
+		}
+
+		/** 
+		 * @brief = operator, grab chunks
+		 */
+		const DynBuffer& operator = (DynBuffer&& v) {
+			if (this != &v) {
+				clear();
+				BaseBuffer::operator = (v);
+				m_head = v.m_head;
+				m_tail = v.m_tail;
 				m_alloter = v.m_alloter;
+				v.m_head = v.m_tail = NULL;
+				v.m_length = 0;
 			}
 			return *this;
 		}
 
 		struct Chunk;
 
+		/**
+		 * @brief read position owned by caller, locate forward from last chunk
+		 * @note reset it after data removed or split, chunk may be freed
+		 */
+		struct Cursor
+		{
+			/**
+			 * @brief locate from head next time
+			 */
+			void	reset() {
+				chunk = NULL;
+				pos = 0;
+			}
+
+			/** last located chunk */
+			Chunk*	chunk = {NULL};
+			/** data offset of last located chunk */
+			length_t pos = {0};
+		};
+
 	public:
 		/** 
 		 * @brief write data from buffer to dyn
 		 * @param data src buffer
 		 * @param len write len
+		 * @return length written, short if chunk alloc failed
 		 */
 		virtual length_t write(const void* data, length_t len);
 
+		/** 
+		 * @brief write data and chain crc32c, computed while copying
+		 * @param crc last crc, updated with data written
+		 */
+		length_t	write(const void* data, length_t len, uint32_t& crc);
+
 		/**
 		 * @brief handle data
 		 * @param handle function
@@ -74,6 +129,19 @@ namespace common {
 		virtual length_t dispatch(data_handle_t handle, void* ptr,
 				length_t len = BaseBuffer::c_invalid_length, length_t off = 0) const;
 
+		/**
+		 * @brief handle data, locate from cursor and move it
+		 * @param cursor read position of caller, sequential parse is amortized O(1)
+		 **/
+		length_t	dispatch(Cursor& cursor, data_handle_t handle, void* ptr,
+				length_t len, length_t off) const;
+
+		/**
+		 * @brief peek data, locate from cursor and move it
+		 **/
+		length_t	peek(Cursor& cursor, void* data, length_t len, length_t off) const;
+		using BaseBuffer::peek;
+
 		/** 
 		 * @brief remove data from dyn buffer
 		 * @param len remove len
@@ -81,6 +149,23 @@ namespace common {
 		 */
 		virtual length_t remove(length_t len);
 
+	public:
+		/**
+		 * @brief export data window as iovec, no copy
+		 * @param iov iovec array
+		 * @param count iovec array size
+		 * @param len export length
+		 * @param off export offset
+		 * @return iovec count filled, stop when array full
+		 **/
+		int			to_iovec(struct ::iovec* iov, int count,
+				length_t len = BaseBuffer::c_invalid_length, length_t off = 0) const;
+
+		/**
+		 * @brief iovec count needed to export data window
+		 **/
+		int			iovec_count(length_t len = BaseBuffer::c_invalid_length, length_t off = 0) const;
+
 	public:
 		/** 
 		 * @brief retrieve last space in buffer, from end to start
@@ -102,6 +187,7 @@ namespace common {
 		/** 
 		 * @brief get new chunk
 		 * @note if set chunk alloter, use it 
+		 * @return NULL if alloter out of memory
 		 */
 		Chunk*		new_chunk();
 
@@ -126,9 +212,50 @@ namespace common {
 		 * @param len read len
 		 * @note will not change data position in chunk if no needed, maybe do
 		 * more work at start chunk and end chunk 
+		 * @return length grabbed, short if chunk view alloc failed
 		 */
 		length_t	append(DynBuffer* dyn, length_t len = BaseBuffer::c_invalid_length);
 
+		/** 
+		 * @brief grab all data from another dyn
+		 * @note chunk keep its own alloter, no copy even alloter not same
+		 */
+		length_t	append(DynBuffer&& dyn) { return append(&dyn); }
+
+		/** 
+		 * @brief share data from another dyn, append as read only view
+		 * @param dyn src dyn buffer
+		 * @param len share len
+		 * @param off share offset
+		 * @return shared length, short if chunk view alloc failed
+		 */
+		length_t	share(const DynBuffer* dyn, length_t len = BaseBuffer::c_invalid_length, length_t off = 0);
+
+		/** 
+		 * @brief get data window sharing chunk storage, no copy
+		 * @param off window offset
+		 * @param len window length
+		 * @note shared storage is copy on write, new data go to new chunk
+		 */
+		DynBuffer	slice(length_t off, length_t len = BaseBuffer::c_invalid_length) const {
+			DynBuffer dyn(m_alloter);
+			dyn.share(this, len, off);
+			return dyn;
+		}
+
+		/** 
+		 * @brief get whole data sharing chunk storage
+		 */
+		DynBuffer	clone() const { return slice(0); }
+
+		/** 
+		 * @brief move data after off to new dyn
+		 * @param off split offset, keep data before it
+		 * @note chunk across off shared by both
+		 * @note empty and nothing moved if chunk view alloc failed
+		 */
+		DynBuffer	split(length_t off);
+
 		/** 
 		 * @brief close old data and attach to another dyn
 		 * @param dyn the src dyn
@@ -193,6 +320,23 @@ namespace common {
 		 */
 		Chunk*		append_chunk(Chunk* chunk = NULL);
 
+		/** 
+		 * @brief new view of chunk storage
+		 * @param chunk the src chunk
+		 * @param off view offset from chunk data start
+		 * @param len view length
+		 * @return NULL if alloc failed, storage refer not taken
+		 */
+		Chunk*		share_chunk(Chunk* chunk, length_t off, length_t len);
+
+		/** 
+		 * @brief find chunk holding data offset
+		 * @param off data offset, return offset in chunk
+		 * @param cursor if set, start from it when off not before it, and move it
+		 * @return null if exceed data length
+		 */
+		Chunk*		locate(length_t& off, Cursor* cursor = NULL) const;
+
 	public:
 		/** start chunk */
 		Chunk*	m_head = {NULL};
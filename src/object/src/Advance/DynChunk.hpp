@@ -8,6 +8,8 @@ namespace common {
 /**
  * @brief data chunk used for dyn buffer
  * @note not check opt length in chunk
+ * @note chunk may be a view of another chunk storage, storage freed
+ * when the last reference released, shared storage is read only
  */
 struct DynBuffer::Chunk
 {
@@ -48,7 +50,7 @@ public:
 	/**
 	 * @brief check if chunk is full
 	 */
-	bool		full() { return end >= total(); }
+	bool		full() { return remain() == 0; }
 
 	/**
 	 * @brief check if chunk is empty
@@ -56,9 +58,19 @@ public:
 	bool		empty() { return beg >= end; }
 
 	/**
-	 * @brief remain len for new data
+	 * @brief remain len for new data, no space if storage shared
 	 */
-	length_t	remain() { return total() - end; }
+	length_t	remain() { return shared() ? 0 : total() - end; }
+
+	/**
+	 * @brief chunk hold the storage
+	 */
+	Chunk*		storage() { return share ? share : this; }
+
+	/**
+	 * @brief check if storage referenced by other chunk
+	 */
+	bool		shared() { return share || ref > 1; }
 
 	/**
 	 * @brief buffer position for read
@@ -115,6 +127,12 @@ public:
 	Chunk*		next = {NULL};
 	/** data start */
 	byte_t*		data = {NULL};
+	/** storage chunk if this is a view */
+	Chunk*		share = {NULL};
+	/** storage reference count, valid for storage chunk */
+	volatile int64_t ref = {1};
+	/** storage alloter, valid for storage chunk */
+	BaseAlloter* alloter = {NULL};
 };
 
 }
@@ -0,0 +1,154 @@
+
+#pragma once
+
+#include "Common/Define.hpp"
+#include "Common/Atomic.hpp"
+
+namespace common
+{
+	/**
+	 * lock free intrusive stack of free piece (treiber stack)
+	 *
+	 * @note next pointer kept in the first word of piece, piece length must >= 8;
+	 * 		 head keep a 16-bit tag in high bits of pointer against ABA, user
+	 * 		 space pointer must within 48 bits
+	 * @note pop may read next of piece just poped by others, piece once in stack
+	 * 		 can be freed only when quiet, no pop in progress
+	 */
+	class FreeStack
+	{
+	public:
+		FreeStack() {}
+
+	public:
+		/**
+		 * push piece
+		 **/
+		void	push(void* data) { push(data, data, 1); }
+
+		/**
+		 * push linked piece chain from first to last, in one exchange
+		 **/
+		void	push(void* first, void* last, int64_t count) {
+			assert(((uint64_t)first & ~c_pointer_mask) == 0);
+			int64_t head = m_head;
+			while (true) {
+				next(last) = pointer(head);
+				int64_t swap = packed(first, tag(head) + 1);
+				int64_t prev = atomic_comp_swap64(&m_head, swap, head);
+				if (prev == head) {
+					break;
+				}
+				head = prev;
+			}
+			atomic_add64(&m_size, count);
+		}
+
+		/**
+		 * pop piece, NULL if empty
+		 **/
+		void*	pop() {
+			void* data = NULL;
+			pop(&data, 1);
+			return data;
+		}
+
+		/**
+		 * pop at most count piece
+		 * @return piece count poped
+		 **/
+		int		pop(void** array, int count) {
+			/** reader registered before load head, pair with quiet */
+			atomic_inc64(&m_reader);
+			int index = 0;
+			for (; index < count; index++) {
+				if (!(array[index] = pop_one())) {
+					break;
+				}
+			}
+			atomic_dec64(&m_reader);
+			if (index > 0) {
+				atomic_add64(&m_size, -index);
+			}
+			return index;
+		}
+
+		/**
+		 * check if no pop in progress, piece poped before can be freed now
+		 **/
+		bool	quiet() { return m_reader == 0; }
+
+		/**
+		 * get piece count, not exactly when concurrent
+		 **/
+		int64_t	size() { return m_size; }
+
+		/**
+		 * check if empty
+		 **/
+		bool	empty() { return pointer(m_head) == NULL; }
+
+	public:
+		/**
+		 * get next pointer kept in piece
+		 **/
+		static void*& next(void* data) { return *(void**)data; }
+
+	protected:
+		/**
+		 * pop one piece, inside reader
+		 **/
+		void*	pop_one() {
+			int64_t head = m_head;
+			while (true) {
+				void* data = pointer(head);
+				if (!data) {
+					return NULL;
+				}
+				/** data may be poped and reused by others, tag will change then */
+				int64_t swap = packed(next(data), tag(head) + 1);
+				int64_t prev = atomic_comp_swap64(&m_head, swap, head);
+				if (prev == head) {
+					return data;
+				}
+				head = prev;
+			}
+		}
+
+		static_assert(sizeof(void*) == 8, "free stack pack pointer in 64 bits");
+
+		/** pointer bits in packed head */
+		static const int c_pointer_bits = 48;
+		/** pointer mask in packed head */
+		static const uint64_t c_pointer_mask = (1ULL << c_pointer_bits) - 1;
+
+		/**
+		 * get pointer part
+		 **/
+		static void* pointer(int64_t head) { return (void*)((uint64_t)head & c_pointer_mask); }
+
+		/**
+		 * get tag part
+		 **/
+		static uint64_t tag(int64_t head) { return (uint64_t)head >> c_pointer_bits; }
+
+		/**
+		 * pack pointer and tag
+		 **/
+		static int64_t packed(void* data, uint64_t tag) {
+			return (int64_t)(((uint64_t)data & c_pointer_mask) | (tag << c_pointer_bits));
+		}
+
+	protected:
+		/** packed head, tag and pointer */
+		volatile int64_t m_head = { 0 };
+		/** piece count */
+		volatile int64_t m_size = { 0 };
+		/** pop in progress */
+		volatile int64_t m_reader = { 0 };
+	};
+}
+
+#if COMMON_SPACE
+	using common::FreeStack;
+#endif
@@ -0,0 +1,568 @@
+
+#include <string>
+#include <cstring>
+#include <immintrin.h>
+
+#include "Advance/FastHash.hpp"
+#include "Advance/Hash.hpp"
+
+namespace common {
+
+	/** reflected castagnoli polynomial */
+	static const uint32_t c_crc32c_poly = 0x82F63B78;
+
+	/**
+	 * slicing table, table[0] for byte, table[n] for byte followed by n zero byte
+	 **/
+	struct Crc32cTable
+	{
+		Crc32cTable() {
+			for (uint32_t i = 0; i < 256; i++) {
+				uint32_t crc = i;
+				for (int bit = 0; bit < 8; bit++) {
+					crc = (crc >> 1) ^ (c_crc32c_poly & (0 - (crc & 1)));
+				}
+				data[0][i] = crc;
+			}
+			for (uint32_t i = 0; i < 256; i++) {
+				for (int n = 1; n < 8; n++) {
+					data[n][i] = (data[n - 1][i] >> 8) ^ data[0][data[n - 1][i] & 0xFF];
+				}
+			}
+		}
+		uint32_t data[8][256];
+	};
+
+	static inline uint64_t
+	read64(const byte_t* data) {
+		uint64_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	static inline uint32_t
+	read32(const byte_t* data) {
+		uint32_t value;
+		memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	static uint32_t
+	crc32c_soft(uint32_t crc, const byte_t* data, size_t len) {
+		static Crc32cTable s_table;
+		const uint32_t (*table)[256] = s_table.data;
+
+		for (; len >= 8; len -= 8, data += 8) {
+			uint64_t value = read64(data) ^ crc;
+			crc = table[7][value & 0xFF] ^ table[6][(value >> 8) & 0xFF]
+				^ table[5][(value >> 16) & 0xFF] ^ table[4][(value >> 24) & 0xFF]
+				^ table[3][(value >> 32) & 0xFF] ^ table[2][(value >> 40) & 0xFF]
+				^ table[1][(value >> 48) & 0xFF] ^ table[0][value >> 56];
+		}
+		for (; len > 0; len--, data++) {
+			crc = (crc >> 8) ^ table[0][(crc ^ (uint8_t)*data) & 0xFF];
+		}
+		return crc;
+	}
+
+	__attribute__((target("sse4.2"))) static uint32_t
+	crc32c_sse42(uint32_t crc, const byte_t* data, size_t len) {
+		uint64_t value = crc;
+		for (; len >= 8; len -= 8, data += 8) {
+			value = _mm_crc32_u64(value, read64(data));
+		}
+		crc = (uint32_t)value;
+		for (; len > 0; len--, data++) {
+			crc = _mm_crc32_u8(crc, (uint8_t)*data);
+		}
+		return crc;
+	}
+
+	__attribute__((target("sse4.2"))) static uint32_t
+	crc32c_copy_sse42(uint32_t crc, byte_t* dst, const byte_t* src, size_t len) {
+		uint64_t value = crc;
+		for (; len >= 8; len -= 8, src += 8, dst += 8) {
+			uint64_t data = read64(src);
+			memcpy(dst, &data, sizeof(data));
+			value = _mm_crc32_u64(value, data);
+		}
+		crc = (uint32_t)value;
+		for (; len > 0; len--, src++, dst++) {
+			*dst = *src;
+			crc = _mm_crc32_u8(crc, (uint8_t)*src);
+		}
+		return crc;
+	}
+
+	static uint32_t
+	crc32c_copy_soft(uint32_t crc, byte_t* dst, const byte_t* src, size_t len) {
+		memcpy(dst, src, len);
+		return crc32c_soft(crc, dst, len);
+	}
+
+	typedef uint32_t (*crc32c_t)(uint32_t crc, const byte_t* data, size_t len);
+
+	/** crc kernel name */
+	static const char* s_crc_kernel = "table";
+
+	/**
+	 * choose crc kernel by cpu, only once
+	 **/
+	static crc32c_t
+	crc32c_select() {
+		static crc32c_t s_crc32c = []() -> crc32c_t {
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("sse4.2")) {
+				s_crc_kernel = "sse4.2";
+				return crc32c_sse42;
+			}
+			return crc32c_soft;
+		}();
+		return s_crc32c;
+	}
+
+	uint32_t
+	crc32c(const void* data, size_t len, uint32_t crc) {
+		return ~crc32c_select()(~crc, (const byte_t*)data, len);
+	}
+
+	uint32_t
+	crc32c_copy(void* dst, const void* src, size_t len, uint32_t crc) {
+		static bool s_hardware = crc32c_select() == crc32c_sse42;
+		return ~(s_hardware ? crc32c_copy_sse42 : crc32c_copy_soft)(~crc, (byte_t*)dst, (const byte_t*)src, len);
+	}
+
+	uint32_t
+	crc32c_table(const void* data, size_t len, uint32_t crc) {
+		return ~crc32c_soft(~crc, (const byte_t*)data, len);
+	}
+
+	static length_t
+	crc32c_handle(void* ptr, const byte_t* data, length_t len) {
+		uint32_t* crc = (uint32_t*)ptr;
+		*crc = crc32c(data, len, *crc);
+		return len;
+	}
+
+	uint32_t
+	crc32c(const BaseBuffer& buffer, length_t len, length_t off, uint32_t crc) {
+		buffer.dispatch(crc32c_handle, &crc, len, off);
+		return crc;
+	}
+
+	uint32_t
+	checksum(int type, const void* data, size_t len) {
+		if (type == hash::CT_legacy) {
+			return ::SuperFastHash((const char*)data, (int)len);
+		}
+		return crc32c(data, len);
+	}
+
+	static const uint64_t c_prime32_1 = 0x9E3779B1U;
+	static const uint64_t c_prime32_2 = 0x85EBCA77U;
+	static const uint64_t c_prime32_3 = 0xC2B2AE3DU;
+	static const uint64_t c_prime64_1 = 0x9E3779B185EBCA87ULL;
+	static const uint64_t c_prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+	static const uint64_t c_prime64_3 = 0x165667B19E3779F9ULL;
+	static const uint64_t c_prime64_4 = 0x85EBCA77C2B2AE63ULL;
+	static const uint64_t c_prime64_5 = 0x27D4EB2F165667C5ULL;
+
+	/**
+	 * secret key, stripe key roll 8 byte each stripe in block, scramble
+	 * key and last stripe key take the tail
+	 **/
+	static const uint8_t c_secret_data[192] = {
+		0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+		0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+		0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+		0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+		0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+		0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+		0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+		0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+		0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+		0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+		0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+		0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+	};
+	static const byte_t* const c_secret = (const byte_t*)c_secret_data;
+	/** scramble key offset */
+	static const int c_scramble_key = 128;
+	/** last stripe key offset, not aligned with stripe key */
+	static const int c_last_key = 121;
+	/** merge key offset */
+	static const int c_merge_key = 11;
+
+	static inline uint64_t
+	mum(uint64_t a, uint64_t b) {
+		__uint128_t value = (__uint128_t)a * b;
+		return (uint64_t)value ^ (uint64_t)(value >> 64);
+	}
+
+	static inline uint64_t
+	avalanche(uint64_t hash) {
+		hash ^= hash >> 37;
+		hash *= 0x165667919E3779F9ULL;
+		return hash ^ (hash >> 32);
+	}
+
+	/**
+	 * hash data no longer than one stripe, multiply mix 16 byte each round
+	 **/
+	static uint64_t
+	short_hash(const byte_t* data, size_t len, uint64_t seed) {
+		uint64_t a = 0, b = 0;
+		seed ^= c_prime64_1;
+		if (len <= 16) {
+			if (len >= 4) {
+				size_t mid = (len >> 3) << 2;
+				a = ((uint64_t)read32(data) << 32) | read32(data + mid);
+				b = ((uint64_t)read32(data + len - 4) << 32) | read32(data + len - 4 - mid);
+
+			} else if (len > 0) {
+				const uint8_t* ptr = (const uint8_t*)data;
+				a = ((uint64_t)ptr[0] << 16) | ((uint64_t)ptr[len >> 1] << 8) | ptr[len - 1];
+			}
+
+		} else {
+			size_t remain = len;
+			const byte_t* ptr = data;
+			for (; remain > 16; remain -= 16, ptr += 16) {
+				seed = mum(read64(ptr) ^ c_prime64_2, read64(ptr + 8) ^ seed);
+			}
+			a = read64(data + len - 16);
+			b = read64(data + len - 8);
+		}
+		return mum(c_prime64_3 ^ len, mum(a ^ c_prime64_2, b ^ seed));
+	}
+
+	static inline void
+	stripe_scalar(uint64_t* acc, const byte_t* data, const byte_t* key) {
+		for (int i = 0; i < 8; i++) {
+			uint64_t value = read64(data + i * 8);
+			uint64_t mix = value ^ read64(key + i * 8);
+			acc[i ^ 1] += value;
+			acc[i] += (mix & 0xFFFFFFFF) * (mix >> 32);
+		}
+	}
+
+	static inline void
+	scramble(uint64_t* acc, const byte_t* key) {
+		for (int i = 0; i < 8; i++) {
+			uint64_t value = acc[i];
+			value ^= value >> 47;
+			value ^= read64(key + i * 8);
+			acc[i] = value * c_prime32_1;
+		}
+	}
+
+	static void
+	accumulate_scalar(uint64_t* acc, const byte_t* data, size_t count, uint64_t& stripe) {
+		for (size_t n = 0; n < count; n++, data += hash::c_stripe) {
+			stripe_scalar(acc, data, c_secret + (stripe % hash::c_block_stripe) * 8);
+			if (++stripe % hash::c_block_stripe == 0) {
+				scramble(acc, c_secret + c_scramble_key);
+			}
+		}
+	}
+
+	__attribute__((target("avx2"))) static void
+	accumulate_avx2(uint64_t* acc, const byte_t* data, size_t count, uint64_t& stripe) {
+		__m256i lane[2] = { _mm256_loadu_si256((const __m256i*)acc),
+							_mm256_loadu_si256((const __m256i*)(acc + 4)) };
+		for (size_t n = 0; n < count; n++, data += hash::c_stripe) {
+			const byte_t* key = c_secret + (stripe % hash::c_block_stripe) * 8;
+			for (int i = 0; i < 2; i++) {
+				__m256i value = _mm256_loadu_si256((const __m256i*)(data + i * 32));
+				__m256i mix = _mm256_xor_si256(value, _mm256_loadu_si256((const __m256i*)(key + i * 32)));
+				__m256i product = _mm256_mul_epu32(mix, _mm256_srli_epi64(mix, 32));
+				/** value of lane i added to lane i ^ 1 */
+				__m256i swap = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+				lane[i] = _mm256_add_epi64(lane[i], _mm256_add_epi64(product, swap));
+			}
+			if (++stripe % hash::c_block_stripe == 0) {
+				_mm256_storeu_si256((__m256i*)acc, lane[0]);
+				_mm256_storeu_si256((__m256i*)(acc + 4), lane[1]);
+				scramble(acc, c_secret + c_scramble_key);
+				lane[0] = _mm256_loadu_si256((const __m256i*)acc);
+				lane[1] = _mm256_loadu_si256((const __m256i*)(acc + 4));
+			}
+		}
+		_mm256_storeu_si256((__m256i*)acc, lane[0]);
+		_mm256_storeu_si256((__m256i*)(acc + 4), lane[1]);
+	}
+
+	typedef void (*accumulate_t)(uint64_t* acc, const byte_t* data, size_t count, uint64_t& stripe);
+
+	/** fast hash kernel name */
+	static const char* s_fast_kernel = "scalar";
+
+	/**
+	 * choose fast hash kernel by cpu, only once
+	 **/
+	static accumulate_t
+	accumulate_select() {
+		static accumulate_t s_accumulate = []() -> accumulate_t {
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2")) {
+				s_fast_kernel = "avx2";
+				return accumulate_avx2;
+			}
+			return accumulate_scalar;
+		}();
+		return s_accumulate;
+	}
+
+	const char*
+	hash_kernel() {
+		static std::string s_kernel;
+		if (s_kernel.empty()) {
+			crc32c_select();
+			accumulate_select();
+			s_kernel = std::string(s_crc_kernel) + "+" + s_fast_kernel;
+		}
+		return s_kernel.c_str();
+	}
+
+	void
+	FastHasher::reset(uint64_t seed) {
+		const uint64_t init[8] = { c_prime32_3, c_prime64_1, c_prime64_2, c_prime64_3,
+								   c_prime64_4, c_prime32_2, c_prime64_5, c_prime32_1 };
+		for (int i = 0; i < 8; i++) {
+			m_acc[i] = init[i] + ((i & 1) ? 0 - seed : seed);
+		}
+		m_size = 0;
+		m_total = 0;
+		m_stripe = 0;
+		m_seed = seed;
+	}
+
+	void
+	FastHasher::consume(const byte_t* data, size_t count) {
+		(m_simd ? accumulate_select() : accumulate_scalar)(m_acc, data, count, m_stripe);
+	}
+
+	void
+	FastHasher::update(const void* ptr, size_t len) {
+		const byte_t* data = (const byte_t*)ptr;
+		m_total += len;
+		if (m_size + len <= hash::c_stripe) {
+			memcpy(m_buffer + m_size, data, len);
+			m_size += len;
+			return;
+		}
+
+		/** buffer full and more data follow, accumulate it */
+		if (m_size > 0) {
+			size_t fill = hash::c_stripe - m_size;
+			memcpy(m_buffer + m_size, data, fill);
+			consume(m_buffer, 1);
+			data += fill;
+			len -= fill;
+			m_size = 0;
+		}
+
+		/** keep last stripe, even if full */
+		size_t count = (len - 1) / hash::c_stripe;
+		consume(data, count);
+		data += count * hash::c_stripe;
+		len -= count * hash::c_stripe;
+		memcpy(m_buffer, data, len);
+		m_size = len;
+	}
+
+	static length_t
+	fast_hash_handle(void* ptr, const byte_t* data, length_t len) {
+		((FastHasher*)ptr)->update(data, len);
+		return len;
+	}
+
+	void
+	FastHasher::update(const BaseBuffer& buffer, length_t len, length_t off) {
+		buffer.dispatch(fast_hash_handle, this, len, off);
+	}
+
+	uint64_t
+	FastHasher::digest() const {
+		if (m_total <= hash::c_stripe) {
+			return short_hash(m_buffer, m_size, m_seed);
+		}
+
+		/** last stripe zero padded, accumulate with key not used by block */
+		uint64_t acc[8];
+		memcpy(acc, m_acc, sizeof(acc));
+		byte_t last[hash::c_stripe] = {};
+		memcpy(last, m_buffer, m_size);
+		stripe_scalar(acc, last, c_secret + c_last_key);
+
+		uint64_t hash = m_total * c_prime64_1;
+		for (int i = 0; i < 4; i++) {
+			const byte_t* key = c_secret + c_merge_key + i * 16;
+			hash += mum(acc[2 * i] ^ read64(key), acc[2 * i + 1] ^ read64(key + 8));
+		}
+		return avalanche(hash);
+	}
+
+	uint64_t
+	fast_hash(const void* data, size_t len, uint64_t seed) {
+		if (len <= hash::c_stripe) {
+			return short_hash((const byte_t*)data, len, seed);
+		}
+		FastHasher hasher(seed);
+		hasher.update(data, len);
+		return hasher.digest();
+	}
+
+	uint64_t
+	fast_hash(const BaseBuffer& buffer, length_t len, length_t off, uint64_t seed) {
+		FastHasher hasher(seed);
+		hasher.update(buffer, len, off);
+		return hasher.digest();
+	}
+}
+
+#if COMMON_TEST
+#include <vector>
+#include "Common/LogHelper.hpp"
+#include "Common/Display.hpp"
+#include "Advance/DynBuffer.hpp"
+#include "Perform/Timer.hpp"
+
+namespace common {
+namespace tester {
+
+	/**
+	 * hash speed of given block size
+	 **/
+	template<class Hash>
+	void
+	__hash_speed(const char* name, const std::vector<byte_t>& data, size_t block, Hash hash)
+	{
+		const int64_t total = (int64_t)1 << 28;
+		int64_t loop = total / block;
+		uint64_t value = 0;
+		CREATE_TIMER;
+		for (int64_t i = 0; i < loop; i++) {
+			value = value * 31 + hash(&data[(i * block) % (data.size() - block)], block);
+		}
+		ctime_t time = timer.check();
+		log_info("hash " << name << ", block " << block << ", "
+			<< string_speed(loop * block, time) << ", check " << (value & 0xFF));
+	}
+
+	void
+	hash_test()
+	{
+		/** known value, chained same as whole */
+		success(crc32c("123456789", 9) == 0xE3069283);
+		success(crc32c_table("123456789", 9) == 0xE3069283);
+		success(crc32c("56789", 5, crc32c("1234", 4)) == 0xE3069283);
+		success(crc32c("", 0) == 0);
+		char copy[16] = {};
+		success(crc32c_copy(copy, "123456789", 9) == 0xE3069283 && strcmp(copy, "123456789") == 0);
+
+		std::vector<byte_t> data(c_length_1M + 4096);
+		for (size_t i = 0; i < data.size(); i++) {
+			data[i] = (byte_t)(i * 131 + (i >> 9));
+		}
+
+		/** hardware same as table, streaming same as one shot, every length and split */
+		for (size_t len = 0; len < 2048; len += (len < 300 ? 1 : 37)) {
+			const byte_t* ptr = &data[len % 61];
+			uint32_t crc = crc32c(ptr, len);
+			success(crc == crc32c_table(ptr, len));
+			std::vector<byte_t> dst(len + 1);
+			success(crc32c_copy(&dst[0], ptr, len) == crc && memcmp(&dst[0], ptr, len) == 0);
+
+			uint64_t value = fast_hash(ptr, len, len);
+			FastHasher scalar(len, false);
+			scalar.update(ptr, len);
+			success(scalar.digest() == value);
+
+			for (size_t split = 0; split <= len; split += 1 + split / 3) {
+				success(crc32c(ptr + split, len - split, crc32c(ptr, split)) == crc);
+
+				FastHasher hasher(len);
+				hasher.update(ptr, split);
+				hasher.update(ptr + split, len - split);
+				success(hasher.digest() == value);
+			}
+		}
+
+		/** different seed, one bit change */
+		uint64_t origin = fast_hash(&data[0], 1000);
+		success(fast_hash(&data[0], 1000, 1) != origin);
+		data[500] ^= 1;
+		success(fast_hash(&data[0], 1000) != origin);
+		data[500] ^= 1;
+		success(fast_hash(&data[0], 8) != fast_hash(&data[0], 9));
+
+		/** hash across chunks without gather */
+		const length_t total = 250 * 4099;
+		DynBuffer buffer;
+		for (length_t pos = 0; pos < total; pos += 4099) {
+			buffer.write(&data[pos], 4099);
+		}
+		success(buffer.length() == total);
+		success(crc32c(buffer) == crc32c(&data[0], total));
+		success(fast_hash(buffer) == fast_hash(&data[0], total));
+		length_t off = DynBuffer::c_length - 777;
+		success(crc32c(buffer, 5000, off) == crc32c(&data[off], 5000));
+		success(fast_hash(buffer, 5000, off, 3) == fast_hash(&data[off], 5000, 3));
+
+		/** crc computed while write, same as crc after write */
+		uint32_t crc = 0;
+		DynBuffer check;
+		for (length_t pos = 0; pos < total; pos += 4099) {
+			check.write(&data[pos], 4099, crc);
+		}
+		success(crc == crc32c(buffer) && check.length() == total);
+
+		for (int type = 0; type < 3; type++) {
+			CREATE_TIMER;
+			for (int loop = 0; loop < 64; loop++) {
+				DynBuffer ingest;
+				crc = 0;
+				for (length_t pos = 0; pos < total; pos += 4099) {
+					if (type == 2) {
+						ingest.write(&data[pos], 4099, crc);
+					} else {
+						ingest.write(&data[pos], 4099);
+					}
+				}
+				if (type == 1) {
+					crc = crc32c(ingest);
+				}
+			}
+			ctime_t time = timer.check();
+			log_info("dyn write, " << (type == 0 ? "no check" : (type == 1 ? "check after write" : "check while write"))
+				<< ", " << string_speed((int64_t)64 * total, time));
+		}
+
+		log_info("hash kernel " << hash_kernel());
+		for (size_t block : { (size_t)16, (size_t)64, (size_t)c_length_4K, (size_t)c_length_64K }) {
+			__hash_speed("super fast", data, block, [](const byte_t* ptr, size_t len) {
+				return (uint64_t)::SuperFastHash((const char*)ptr, (int)len);
+			});
+			__hash_speed("crc32c table", data, block, [](const byte_t* ptr, size_t len) {
+				return (uint64_t)crc32c_table(ptr, len);
+			});
+			__hash_speed("crc32c", data, block, [](const byte_t* ptr, size_t len) {
+				return (uint64_t)crc32c(ptr, len);
+			});
+			__hash_speed("fast hash", data, block, [](const byte_t* ptr, size_t len) {
+				return fast_hash(ptr, len);
+			});
+			static byte_t s_dst[c_length_64K];
+			__hash_speed("memcpy", data, block, [](const byte_t* ptr, size_t len) {
+				memcpy(s_dst, ptr, len);
+				return (uint64_t)s_dst[len - 1];
+			});
+			__hash_speed("crc32c copy", data, block, [](const byte_t* ptr, size_t len) {
+				return (uint64_t)crc32c_copy(s_dst, ptr, len);
+			});
+		}
+	}
+}
+}
+#endif
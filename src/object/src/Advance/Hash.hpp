@@ -0,0 +1,134 @@
+
+#pragma once
+
+#include "Common/Type.hpp"
+#include "Advance/BaseBuffer.hpp"
+
+namespace common
+{
+	namespace hash {
+		/**
+		 * checksum type recorded on disk
+		 **/
+		enum Checksum {
+			/** SuperFastHash, data written before checksum recorded */
+			CT_legacy = 0,
+			/** crc32c */
+			CT_crc32c,
+		};
+		/** fast hash stripe length */
+		static const int c_stripe = 64;
+		/** fast hash stripe count of each block, accumulator scrambled after block */
+		static const int c_block_stripe = 16;
+	}
+
+	/**
+	 * @brief crc32c (castagnoli), sse4.2 instruction if cpu support, or
+	 * software table
+	 * @param crc last crc, for chained call
+	 * @note crc32c("123456789") == 0xE3069283
+	 **/
+	uint32_t	crc32c(const void* data, size_t len, uint32_t crc = 0);
+
+	/**
+	 * @brief crc32c of buffer data, chunk by chunk without gather
+	 **/
+	uint32_t	crc32c(const BaseBuffer& buffer, length_t len = BaseBuffer::c_invalid_length,
+					length_t off = 0, uint32_t crc = 0);
+
+	/**
+	 * @brief copy data and get crc32c in one pass, source read only once
+	 * @param crc last crc, for chained call
+	 **/
+	uint32_t	crc32c_copy(void* dst, const void* src, size_t len, uint32_t crc = 0);
+
+	/**
+	 * @brief crc32c, software table only
+	 **/
+	uint32_t	crc32c_table(const void* data, size_t len, uint32_t crc = 0);
+
+	/**
+	 * @brief get hash kernel, crc and fast hash, such as sse4.2+avx2
+	 **/
+	const char* hash_kernel();
+
+	/**
+	 * @brief checksum for integrity by type
+	 **/
+	uint32_t	checksum(int type, const void* data, size_t len);
+
+	/**
+	 * @brief fast 64 bit hash, for key hashing, not for integrity
+	 * @note xxh3 like, 8 lane multiply accumulate, avx2 and scalar
+	 * kernel give same result; output not compatible with xxh3
+	 **/
+	class FastHasher
+	{
+	public:
+		/**
+		 * @param seed hash seed
+		 * @param simd use avx2 kernel if cpu support, same result as scalar
+		 **/
+		FastHasher(uint64_t seed = 0, bool simd = true)
+			: m_simd(simd) { reset(seed); }
+
+	public:
+		/**
+		 * @brief reset state
+		 **/
+		void		reset(uint64_t seed = 0);
+
+		/**
+		 * @brief add data
+		 **/
+		void		update(const void* data, size_t len);
+
+		/**
+		 * @brief add buffer data, chunk by chunk without gather
+		 **/
+		void		update(const BaseBuffer& buffer, length_t len = BaseBuffer::c_invalid_length,
+						length_t off = 0);
+
+		/**
+		 * @brief get hash of data added, state not changed
+		 **/
+		uint64_t	digest() const;
+
+	protected:
+		/**
+		 * @brief accumulate stripes
+		 **/
+		void		consume(const byte_t* data, size_t count);
+
+	protected:
+		/** lane accumulator */
+		uint64_t	m_acc[8];
+		/** data not accumulated, last stripe kept until digest */
+		byte_t		m_buffer[hash::c_stripe];
+		/** buffered length */
+		size_t		m_size = { 0 };
+		/** total data length */
+		uint64_t	m_total = { 0 };
+		/** stripe accumulated */
+		uint64_t	m_stripe = { 0 };
+		/** hash seed */
+		uint64_t	m_seed = { 0 };
+		/** use simd kernel */
+		bool		m_simd = { true };
+	};
+
+	/**
+	 * @brief fast 64 bit hash of data, same as FastHasher
+	 **/
+	uint64_t	fast_hash(const void* data, size_t len, uint64_t seed = 0);
+
+	/**
+	 * @brief fast 64 bit hash of buffer data
+	 **/
+	uint64_t	fast_hash(const BaseBuffer& buffer, length_t len = BaseBuffer::c_invalid_length,
+					length_t off = 0, uint64_t seed = 0);
+}
+
+#if COMMON_SPACE
+	using common::FastHasher;
+#endif
@@ -0,0 +1,313 @@
+
+#include <set>
+#include <memory>
+#include <sstream>
+
+#include "Common/Mutex.hpp"
+#include "Common/Atomic.hpp"
+#include "Common/Display.hpp"
+#include "Common/CodeHelper.hpp"
+#include "Advance/MemAccount.hpp"
+
+namespace common {
+
+class LocalAccount;
+
+thread_local AccountCounter* t_account = NULL;
+thread_local std::shared_ptr<LocalAccount> s_account;
+/** thread local account destroyed, other thread local may still alloc or free */
+thread_local bool s_account_exit = false;
+
+/**
+ * registry of thread account, keep counter of exited thread
+ **/
+class AccountRegistry
+{
+public:
+	/**
+	 * aggregate all thread counter of type
+	 **/
+	void	stat(int type, AccountStat& stat) {
+		Mutex::Locker lock(m_mutex);
+		stat.live = m_retired[type].live;
+		stat.bytes = m_retired[type].bytes;
+		stat.count = m_retired[type].count;
+		for (auto array : m_local) {
+			stat.live += array[type].live;
+			stat.bytes += array[type].bytes;
+			stat.count += array[type].count;
+		}
+		peak(type, stat.live);
+		stat.peak = m_peak[type];
+	}
+
+	/**
+	 * add flushed live change of type, update peak
+	 **/
+	void	flush(int type, int64_t len) {
+		peak(type, atomic_add64(&m_flushed[type], len) + len);
+	}
+
+	/**
+	 * raise peak of type to live
+	 **/
+	void	peak(int type, int64_t live) {
+		int64_t last = m_peak[type];
+		while (live > last) {
+			int64_t prev = atomic_comp_swap64(&m_peak[type], live, last);
+			if (prev == last) {
+				break;
+			}
+			last = prev;
+		}
+	}
+
+public:
+	Mutex	m_mutex = { "account registry" };
+	/** counter array of living thread */
+	std::set<AccountCounter*> m_local;
+	/** counter of exited thread */
+	AccountCounter m_retired[account::AT_max] = {};
+	/** live length flushed by all thread */
+	volatile int64_t m_flushed[account::AT_max] = {};
+	/** max of flushed or aggregated live length */
+	volatile int64_t m_peak[account::AT_max] = {};
+	/** last display status, for rate */
+	AccountStat m_last[account::AT_max];
+	/** type name */
+	const char* m_name[account::AT_max] = {
+		"none", "buffer", "arena", "client", "writer", "reader", "logger",
+	};
+};
+SINGLETON(AccountRegistry, account_registry);
+
+/**
+ * counter of local thread, fold into registry when exit
+ **/
+class LocalAccount
+{
+public:
+	LocalAccount() {
+		Mutex::Locker lock(account_registry().m_mutex);
+		account_registry().m_local.insert(m_array);
+	}
+
+	~LocalAccount() {
+		AccountRegistry& registry = account_registry();
+		Mutex::Locker lock(registry.m_mutex);
+		for (int type = 0; type < account::AT_max; type++) {
+			atomic_add64(&registry.m_retired[type].live, m_array[type].live);
+			atomic_add64(&registry.m_retired[type].bytes, m_array[type].bytes);
+			atomic_add64(&registry.m_retired[type].count, m_array[type].count);
+			registry.flush(type, m_array[type].pending);
+		}
+		registry.m_local.erase(m_array);
+		t_account = NULL;
+		s_account_exit = true;
+	}
+
+public:
+	AccountCounter m_array[account::AT_max] = {};
+};
+
+void
+account_slow(int type, int64_t len)
+{
+	assert(type > account::AT_none && type < account::AT_max);
+	if (!s_account_exit) {
+		s_account = std::make_shared<LocalAccount>();
+		t_account = s_account->m_array;
+		mem_account(type, len);
+		return;
+	}
+	/** thread exiting, account to retired directly */
+	AccountCounter& counter = account_registry().m_retired[type];
+	atomic_add64(&counter.live, len);
+	if (len > 0) {
+		atomic_add64(&counter.bytes, len);
+		at_inc64(counter.count);
+	}
+	account_registry().flush(type, len);
+}
+
+void
+account_flush(int type, AccountCounter& counter)
+{
+	int64_t len = counter.pending;
+	counter.pending = 0;
+	account_registry().flush(type, len);
+}
+
+void
+account_stat(int type, AccountStat& stat)
+{
+	assert(type >= 0 && type < account::AT_max);
+	account_registry().stat(type, stat);
+}
+
+void
+account_name(int type, const char* name)
+{
+	assert(type >= account::AT_user && type < account::AT_max);
+	account_registry().m_name[type] = name;
+}
+
+const char*
+account_name(int type)
+{
+	const char* name = account_registry().m_name[type];
+	return name ? name : "user";
+}
+
+std::string
+account_display(ctime_t last)
+{
+	std::stringstream ss;
+	for (int type = account::AT_none + 1; type < account::AT_max; type++) {
+		AccountStat stat;
+		account_stat(type, stat);
+		if (stat.count == 0) {
+			continue;
+		}
+		AccountStat& prev = account_registry().m_last[type];
+		ss << (ss.tellp() > 0 ? ", " : "account: ") << account_name(type)
+			<< " " << string_size(std::max(stat.live, (int64_t)0))
+			<< " " << string_iops(stat.count - prev.count, last) << "/s"
+			<< " " << string_speed(stat.bytes - prev.bytes, last);
+		prev = stat;
+	}
+	return ss.str();
+}
+
+std::string
+account_summary()
+{
+	std::stringstream ss;
+	for (int type = account::AT_none + 1; type < account::AT_max; type++) {
+		AccountStat stat;
+		account_stat(type, stat);
+		if (stat.count == 0) {
+			continue;
+		}
+		ss << (ss.tellp() > 0 ? ", " : "account: ") << account_name(type)
+			<< " live " << string_size(std::max(stat.live, (int64_t)0))
+			<< " peak " << string_size(stat.peak)
+			<< " total " << string_size(stat.bytes)
+			<< " count " << string_count(stat.count);
+	}
+	return ss.str();
+}
+}
+
+#if COMMON_TEST
+#include "Common/LogHelper.hpp"
+#include "Advance/Arena.hpp"
+#include "Advance/MemPool.hpp"
+#include "Advance/SlabAlloter.hpp"
+#include "Perform/Debug.hpp"
+#include "Perform/Timer.hpp"
+
+namespace common {
+namespace tester {
+
+	void
+	__mem_account_work(BaseAlloter* alloter, int count, void** array)
+	{
+		for (int i = 0; i < count; i++) {
+			array[i] = alloter->_new();
+		}
+	}
+
+	void
+	__mem_account_free(BaseAlloter* alloter, int count, void** array)
+	{
+		for (int i = 0; i < count; i++) {
+			alloter->_del(array[i]);
+		}
+	}
+
+	void
+	mem_account_test()
+	{
+		const int type = account::AT_user;
+		const int count = 10000;
+		account_name(type, "tester");
+		success(std::string(account_name(type)) == "tester");
+
+		AccountStat origin;
+		account_stat(type, origin);
+
+		MemConfig config(128);
+		config.account = type;
+		MemPool pool(config);
+		std::vector<void*> array(count * 4);
+
+		/** alloc in some thread, free in others after they exit */
+		for (int i = 0; i < 4; i++) {
+			single(__mem_account_work, (BaseAlloter*)&pool, count, &array[i * count]);
+		}
+		thread_wait();
+
+		AccountStat stat;
+		account_stat(type, stat);
+		success(stat.live - origin.live == count * 4 * 128);
+		success(stat.count - origin.count == count * 4);
+		log_info(account_summary());
+
+		/** logger hold message only while writing */
+		AccountStat logger;
+		account_stat(account::AT_logger, logger);
+		success(logger.count > 0 && logger.live == 0);
+
+		for (int i = 0; i < 4; i++) {
+			single(__mem_account_free, (BaseAlloter*)&pool, count, &array[i * count]);
+		}
+		thread_wait();
+		account_stat(type, stat);
+		success(stat.live == origin.live && stat.peak >= count * 4 * 128);
+
+		/** peak kept on alloc, not only when sampled */
+		std::vector<void*> burst(count * 8);
+		__mem_account_work(&pool, count * 8, &burst[0]);
+		__mem_account_free(&pool, count * 8, &burst[0]);
+		account_stat(type, stat);
+		success(stat.live == origin.live && stat.peak >= origin.live + count * 8 * 128 - account::c_flush * 2);
+
+		/** slab account class length, arena account bump length */
+		SlabAlloter slab;
+		slab.account(type);
+		void* data = slab._new(100);
+		void* large = slab._new(slab::c_max_len * 2);
+		account_stat(type, stat);
+		success(stat.live - origin.live >= 100 + slab::c_max_len * 2);
+		slab._del(data);
+		slab._del(large);
+
+		Arena arena;
+		arena.account(type);
+		arena._new(1000);
+		account_stat(type, stat);
+		success(stat.live - origin.live >= 1000);
+		arena.reset();
+		account_stat(type, stat);
+		success(stat.live == origin.live);
+
+		/** account cost on hot path */
+		const int64_t total = 5000000;
+		for (int loop = 0; loop < 4; loop++) {
+			MemConfig local(128);
+			local.account = loop % 2 == 0 ? account::AT_none : type;
+			MemPool pool(local);
+
+			CREATE_TIMER;
+			for (int64_t i = 0; i < total; i++) {
+				pool._del(pool._new());
+			}
+			ctime_t time = timer.check();
+			log_info("mem pool " << (loop % 2 == 0 ? "without" : "with   ") << " account, "
+				<< string_iops(total, time) << " ops/s");
+		}
+	}
+}
+}
+#endif
@@ -0,0 +1,134 @@
+
+#pragma once
+
+#include <string>
+
+#include "Common/Define.hpp"
+#include "Common/Const.hpp"
+#include "Common/Time.hpp"
+
+namespace common {
+
+	namespace account {
+		/**
+		 * subsystem memory account type
+		 **/
+		enum AccountType {
+			/** not accounted */
+			AT_none = 0,
+			/** dyn buffer chunk */
+			AT_buffer,
+			/** arena block */
+			AT_arena,
+			/** client context */
+			AT_client,
+			/** writer task */
+			AT_writer,
+			/** reader committed object */
+			AT_reader,
+			/** logger format buffer */
+			AT_logger,
+			/** first one for user define */
+			AT_user,
+			/** max account type */
+			AT_max = 16,
+		};
+
+		/** thread live change flushed for peak when over it */
+		const int64_t c_flush = c_length_64K;
+	}
+
+	/**
+	 * account counter, each thread keep one for each type
+	 **/
+	struct AccountCounter
+	{
+		/** live length, may negative if freed by other thread */
+		volatile int64_t live;
+		/** total alloc length */
+		volatile int64_t bytes;
+		/** total alloc count */
+		volatile int64_t count;
+		/** live change not yet flushed for peak */
+		volatile int64_t pending;
+	};
+
+	/**
+	 * account status aggregated from all thread
+	 **/
+	struct AccountStat
+	{
+		/** live length */
+		int64_t	live = { 0 };
+		/** max live length, tracked within flush length each thread */
+		int64_t	peak = { 0 };
+		/** total alloc length */
+		int64_t	bytes = { 0 };
+		/** total alloc count */
+		int64_t	count = { 0 };
+	};
+
+	/** counter array of current thread, null before first account */
+	extern thread_local AccountCounter* t_account;
+
+	/**
+	 * account of thread first used or exited
+	 **/
+	void	account_slow(int type, int64_t len);
+
+	/**
+	 * flush thread live change, update peak
+	 **/
+	void	account_flush(int type, AccountCounter& counter);
+
+	/**
+	 * account alloc len, negative for free
+	 **/
+	inline void mem_account(int type, int64_t len) {
+		if (type == account::AT_none) {
+			return;
+		}
+		if (t_account) {
+			AccountCounter& counter = t_account[type];
+			counter.live += len;
+			counter.pending += len;
+			if (len > 0) {
+				counter.bytes += len;
+				counter.count++;
+			}
+			if (counter.pending >= account::c_flush || counter.pending <= -account::c_flush) {
+				account_flush(type, counter);
+			}
+
+		} else {
+			account_slow(type, len);
+		}
+	}
+
+	/**
+	 * aggregate account status of type, update peak
+	 **/
+	void	account_stat(int type, AccountStat& stat);
+
+	/**
+	 * set account type name, for user define type
+	 **/
+	void	account_name(int type, const char* name);
+
+	/**
+	 * get account type name
+	 **/
+	const char* account_name(int type);
+
+	/**
+	 * account display, live and alloc rate since last call
+	 *
+	 * @param last elapse since last call
+	 **/
+	std::string account_display(ctime_t last);
+
+	/**
+	 * account summary, live, peak and total
+	 **/
+	std::string account_summary();
+}
@@ -0,0 +1,80 @@
+
+#include <unistd.h>
+#include <algorithm>
+
+#include "Advance/MemGovernor.hpp"
+
+namespace common {
+
+int
+MemGovernor::admit()
+{
+	int level = this->level();
+	if (level != governor::GL_soft) {
+		return level;
+	}
+	at_inc64(m_delayed);
+
+	/** no hard mark, delay at most */
+	int64_t delay = governor::c_delay_max;
+	if (m_hard > m_soft) {
+		delay = delay * (m_used - m_soft) / (m_hard - m_soft);
+	}
+	usleep(std::max(delay, (int64_t)1));
+	return this->level();
+}
+
+MemGovernor&
+mem_governor()
+{
+	static MemGovernor s_governor;
+	return s_governor;
+}
+}
+
+#if COMMON_TEST
+#include "Common/LogHelper.hpp"
+#include "Common/Display.hpp"
+#include "Advance/MemPool.hpp"
+
+namespace common {
+namespace tester {
+
+	void
+	mem_governor_test()
+	{
+		MemGovernor& governor = mem_governor();
+		int64_t origin = governor.used();
+
+		/** pool unit charged, reject when exceed hard */
+		MemConfig config(c_length_64K, 0, c_length_1M);
+		config.timeout = 1;
+		MemPool pool(config);
+		governor.set(origin + 2 * c_length_1M, origin + 4 * c_length_1M);
+
+		std::vector<void*> array;
+		void* data = NULL;
+		bool soft = false;
+		while ((data = pool._new())) {
+			array.push_back(data);
+			if (!soft && governor.level() == governor::GL_soft) {
+				soft = true;
+				success(governor.admit() == governor::GL_soft && governor.delayed() > 0);
+			}
+		}
+		success(soft && governor.level() == governor::GL_hard);
+		success(governor.rejected() > 0 && governor.admit() == governor::GL_hard);
+		log_info("governor, used " << string_size(governor.used() - origin) << ", piece " << array.size()
+			<< ", rejected " << governor.rejected() << ", delayed " << governor.delayed());
+
+		for (auto data : array) {
+			pool._del(data);
+		}
+		usleep(10 * c_time_level[0]);
+		pool.release();
+		success(governor.used() == origin && governor.level() == governor::GL_normal);
+		governor.set(0, 0);
+	}
+}
+}
+#endif
@@ -0,0 +1,130 @@
+
+#pragma once
+
+#include <cstdint>
+
+#include "Common/Define.hpp"
+#include "Common/Atomic.hpp"
+
+namespace common {
+
+	namespace governor {
+		/**
+		 * memory pressure level
+		 **/
+		enum Level {
+			/** below soft mark */
+			GL_normal = 0,
+			/** above soft mark, slow down admission */
+			GL_soft,
+			/** above hard mark, new alloc fail */
+			GL_hard,
+		};
+		/** max admission delay when reach hard mark, us */
+		static const int c_delay_max = 10000;
+	}
+
+	/**
+	 * process wide memory budget, all mem pool unit charged here
+	 *
+	 * @note mark 0 for no limit; charge beyond hard mark fail fast
+	 **/
+	class MemGovernor
+	{
+	public:
+		/**
+		 * set soft and hard mark
+		 **/
+		void	set(int64_t soft, int64_t hard) {
+			assert(hard == 0 || soft <= hard);
+			m_soft = soft;
+			m_hard = hard;
+		}
+
+		/**
+		 * charge len, false if exceed hard mark
+		 **/
+		bool	acquire(int64_t len) {
+			int64_t used = atomic_add64(&m_used, len) + len;
+			if (m_hard != 0 && used > m_hard) {
+				atomic_add64(&m_used, -len);
+				at_inc64(m_rejected);
+				return false;
+			}
+			return true;
+		}
+
+		/**
+		 * give back charged len
+		 **/
+		void	release(int64_t len) { atomic_add64(&m_used, -len); }
+
+		/**
+		 * get current level
+		 **/
+		int		level() {
+			int64_t used = m_used;
+			if (m_hard != 0 && used >= m_hard) {
+				return governor::GL_hard;
+
+			} else if (m_soft != 0 && used >= m_soft) {
+				return governor::GL_soft;
+			}
+			return governor::GL_normal;
+		}
+
+		/**
+		 * admission control, delay more when closer to hard mark
+		 *
+		 * @return level after delay, caller should reject if hard
+		 **/
+		int		admit();
+
+	public:
+		/**
+		 * charged length
+		 **/
+		int64_t	used() { return m_used; }
+
+		/**
+		 * soft mark
+		 **/
+		int64_t	soft() { return m_soft; }
+
+		/**
+		 * hard mark
+		 **/
+		int64_t	hard() { return m_hard; }
+
+		/**
+		 * charge rejected count
+		 **/
+		int64_t	rejected() { return m_rejected; }
+
+		/**
+		 * admission delayed count
+		 **/
+		int64_t	delayed() { return m_delayed; }
+
+	protected:
+		/** charged length */
+		volatile int64_t m_used = { 0 };
+		/** soft mark */
+		volatile int64_t m_soft = { 0 };
+		/** hard mark */
+		volatile int64_t m_hard = { 0 };
+		/** charge rejected */
+		volatile int64_t m_rejected = { 0 };
+		/** admission delayed */
+		volatile int64_t m_delayed = { 0 };
+	};
+
+	/**
+	 * get process memory governor
+	 **/
+	MemGovernor& mem_governor();
+}
+
+#if COMMON_SPACE
+	using common::MemGovernor;
+#endif
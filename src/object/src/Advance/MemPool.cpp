@@ -2,6 +2,12 @@
 #define LOG_CODE 0
 
 #include <sstream>
+#include <memory>
+#include <cstring>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
 
 #include "Common/Const.hpp"
 #include "Common/LogHelper.hpp"
@@ -9,7 +15,11 @@
 #include "Common/Time.hpp"
 #include "Common/Util.hpp"
 #include "Common/CodeHelper.hpp"
+#include "Common/Topology.hpp"
+#include "Common/Atomic.hpp"
 #include "Advance/MemPool.hpp"
+#include "Advance/CacheSlot.hpp"
+#include "Advance/MemGovernor.hpp"
 #include "Advance/Pointer.hpp"
 #include "Advance/SingleList.hpp"
 
@@ -29,6 +39,97 @@ MemConfig::unit_len(uint32_t unit) {
 		: up_align(unit, memory::c_boundary);
 }
 
+/** numa policy prefer node, fallback to others if node exhausted */
+static const int c_mpol_preferred = 1;
+
+/**
+ * map anonymous memory, aligned to huge page if required
+ **/
+static byte_t*
+unit_map(size_t length, bool huge)
+{
+	if (!huge) {
+		void* data = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		return data == MAP_FAILED ? NULL : (byte_t*)data;
+	}
+	/** over map and trim, make huge page boundary */
+	size_t total = length + c_huge_len;
+	void* data = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (data == MAP_FAILED) {
+		return NULL;
+	}
+	byte_t* start = address_align((byte_t*)data, c_huge_len);
+	size_t head = start - (byte_t*)data;
+	if (head) {
+		munmap(data, head);
+	}
+	if (total - head - length) {
+		munmap(start + length, total - head - length);
+	}
+	madvise(start, length, MADV_HUGEPAGE);
+	return start;
+}
+
+/**
+ * alloc unit memory by page type and node
+ *
+ * @param mapped set as mapped length, 0 for heap memory
+ **/
+static byte_t*
+unit_alloc(const MemConfig& config, size_t len, size_t& mapped)
+{
+	mapped = 0;
+	if (config.page == PG_normal && config.node < 0) {
+		return new byte_t[len];
+	}
+
+	byte_t* data = NULL;
+	size_t length = up_align(len, config.page == PG_normal ? c_page_size : c_huge_len);
+	if (config.page == PG_huge) {
+		void* ptr = mmap(NULL, length, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (ptr != MAP_FAILED) {
+			data = (byte_t*)ptr;
+		} else {
+			trace("mem unit map huge page failed, " << strerror(errno) << ", fallback to transparent");
+		}
+	}
+	if (!data && !(data = unit_map(length, config.page != PG_normal))) {
+		log_info("mem unit map failed, " << strerror(errno) << ", fallback to heap");
+		/** heap not aligned as huge page, add slack back */
+		return new byte_t[len + (config.page == PG_normal ? 0 : config.align)];
+	}
+
+	if (config.node >= 0) {
+		/** bind before first touch, so page fault on the node */
+		unsigned long mask = 1UL << config.node;
+		if (syscall(SYS_mbind, data, length, c_mpol_preferred, &mask, sizeof(mask) * 8, 0) != 0) {
+			trace("mem unit bind node " << config.node << " failed, " << strerror(errno));
+		}
+	}
+	mapped = length;
+	return data;
+}
+
+/**
+ * give page inside range back to os
+ **/
+size_t	advise_range(byte_t* beg, byte_t* end);
+
+/**
+ * free unit memory
+ **/
+static void
+unit_free(byte_t*& data, size_t mapped)
+{
+	if (mapped) {
+		munmap(data, mapped);
+		data = NULL;
+	} else {
+		reset_array(data);
+	}
+}
+
 /**
  * memory alloc unit
  *
@@ -42,7 +143,7 @@ public:
 	MemUnit(const MemConfig& config);
 
 	virtual ~MemUnit() {
-		reset_array(m_data);
+		unit_free(m_data, m_mapped);
 	}
 
 public:
@@ -107,6 +208,11 @@ public:
 	 **/
 	uint32_t align() { return m_config.align; }
 
+	/**
+	 * slack over unit length for align, none if mapped at huge page
+	 **/
+	uint32_t slack() { return m_config.page == PG_normal ? align() : 0; }
+
 	/**
 	 * total capacity
 	 **/
@@ -142,6 +248,13 @@ public:
 	 **/
 	bool	timeout() { return m_time.expired(); }
 
+	/**
+	 * give piece data pages back to os, head and tail kept
+	 *
+	 * @return advised length
+	 **/
+	virtual size_t advise();
+
 	/**
 	 * dump prefix string
 	 **/
@@ -246,6 +359,8 @@ public:
 	SingleList m_list = { OFFSET(Head, link) };
 	/** piece or container data start */
 	byte_t*  m_data	 = { NULL };
+	/** mapped length of data, 0 for heap */
+	size_t	 m_mapped = { 0 };
 	/** actual data start */
 	byte_t*  m_start = { NULL };
 	/** piece step */
@@ -254,6 +369,8 @@ public:
 	uint32_t m_tail  = { 0 };
 	/** origin item count */
 	uint32_t m_capacity = { 0 };
+	/** piece pages advised, refault when used again */
+	bool	 m_advised = { false };
 	/** local timer */
 	TimeCheck m_time;
 	/** link in memory pool */
@@ -271,6 +388,35 @@ mem_piece(const void* ptr)
 	return MemUnit::unit(ptr)->piece();
 }
 
+int
+mem_node(const void* ptr)
+{
+	return MemUnit::unit(ptr)->m_config.node;
+}
+
+uint32_t
+mem_tag(const void* ptr)
+{
+	MemUnit::Head* head = MemUnit::piece_head(ptr);
+	assert(MemUnit::check_head(head));
+	return head->tag;
+}
+
+uint32_t
+mem_head()
+{
+	return MemUnit::c_head_len;
+}
+
+void*
+mem_wrap(void* ptr, uint32_t tag)
+{
+	MemUnit::Head* head = new(ptr) MemUnit::Head;
+	head->magic = memory::c_magic;
+	head->tag = tag;
+	return MemUnit::piece_data(head);
+}
+
 MemUnit::MemUnit(const MemConfig& config)
 	: BaseAlloter(config.piece), m_config(config)
 {
@@ -279,12 +425,15 @@ MemUnit::MemUnit(const MemConfig& config)
 	m_time.set(m_config.timeout);
 	/** align head start, b0 = data - ptr */
 	//posix_memalign((void**)&data, getpagesize(), len);
-	byte_t* ptr = malloc_align(m_data, utlen(), align());
-	byte_t* end = m_data + utlen() + align();
+	m_data = unit_alloc(m_config, utlen() + slack(), m_mapped);
+	byte_t* ptr = address_align(m_data, align());
+	byte_t* end = ptr + utlen();
 
-	while (ptr + m_step <= end) {
+	/** unit length counted from aligned start, keep capacity exact */
+	while (ptr + m_step <= end && m_list.size() < m_capacity) {
 		Head* head = new(ptr) Head;
 		head->magic = memory::c_magic;
+		head->tag = m_config.tag;
 		set_tail(head);
 		m_list.enque(head);
 
@@ -359,6 +508,30 @@ MemUnit::format_display()
 		m_config.index, string_size(piece(), false).c_str());
 }
 
+size_t
+advise_range(byte_t* beg, byte_t* end)
+{
+	beg = page_align(beg);
+	end = (byte_t*)((uint64_t)end & ~((uint64_t)c_page_size - 1));
+	if (end <= beg || madvise(beg, end - beg, MADV_DONTNEED) != 0) {
+		return 0;
+	}
+	return end - beg;
+}
+
+size_t
+MemUnit::advise()
+{
+	byte_t* ptr = address_align(m_data, align());
+	size_t total = 0;
+	for (uint32_t count = 0; count < m_capacity; count++) {
+		byte_t* data = piece_data((Head*)ptr);
+		total += advise_range(data, data + piece());
+		ptr = ptr + m_step;
+	}
+	return total;
+}
+
 bool
 MemUnit::check()
 {
@@ -393,8 +566,9 @@ public:
 		piece(config.piece);
 		format_display();
 
-		byte_t* ptr = malloc_align(m_buffer, m_config.utlen, align());
-	    byte_t* end = m_buffer + utlen() + align();
+		m_buffer = unit_alloc(m_config, utlen() + slack(), m_buffer_mapped);
+		byte_t* ptr = address_align(m_buffer, align());
+	    byte_t* end = ptr + utlen();
 
 	    uint32_t count = (end - ptr) / piece();
 	    assert(capacity() >= count);
@@ -418,7 +592,14 @@ public:
 	}
 
 	virtual ~ContainUnit() {
-		reset_array(m_buffer);
+		unit_free(m_buffer, m_buffer_mapped);
+	}
+
+	/**
+	 * container data is out of band, give all buffer pages back
+	 **/
+	virtual size_t advise() {
+		return advise_range(m_buffer, m_buffer + utlen() + slack());
 	}
 
 protected:
@@ -435,12 +616,70 @@ protected:
 public:
 	/** chunk start */
 	byte_t*	m_buffer = { NULL };
+	/** mapped length of chunk, 0 for heap */
+	size_t	m_buffer_mapped = { 0 };
+};
+
+/**
+ * thread local piece cache for one pool
+ *
+ * @note piece alloc and free in local thread without lock, only refill
+ * or flush half of the magazine with pool locked
+ **/
+struct MemPool::Magazine
+{
+public:
+	/**
+	 * check if magazine is empty
+	 **/
+	bool	empty() { return m_size == 0; }
+
+	/**
+	 * pop piece
+	 **/
+	void*	pop() { return m_array[--m_size]; }
+
+	/**
+	 * push piece
+	 **/
+	void	push(void* data) { m_array[m_size++] = data; }
+
+public:
+	/** attached pool */
+	MemPool* m_owner = { NULL };
+	/** current piece count */
+	uint32_t m_size = { 0 };
+	/** piece array */
+	void*	 m_array[memory::c_magazine_max];
+	/** link in pool */
+	ListLink m_link;
 };
 
+/** magazine slot, each pool using magazine take one */
+typedef CacheSlot<MemPool::Magazine, memory::c_magazine_pool> MagazineSlot;
+
+/** bytes reclaimed by memory cycle */
+static int64_t s_reclaimed = 0;
+
+int64_t
+mem_reclaimed()
+{
+	return s_reclaimed;
+}
+
 MemPool::MemPool(const MemConfig& config)
 	: BaseAlloter(config.piece), m_mutex("mem pool"), m_config(config),
-	  m_free(OFFSET(MemUnit, m_link)), m_used(OFFSET(MemUnit, m_link)), m_full(OFFSET(MemUnit, m_link))
+	  m_free(OFFSET(MemUnit, m_link)), m_used(OFFSET(MemUnit, m_link)), m_full(OFFSET(MemUnit, m_link)),
+	  m_magazine(OFFSET(Magazine, m_link))
 {
+	account(m_config.account);
+	if (m_config.magazine != 0) {
+		m_config.magazine = std::min(m_config.magazine, (uint32_t)c_magazine_max);
+		m_slot = MagazineSlot::instance().alloc();
+		if (m_slot < 0) {
+			log_info("mem pool magazine slot exhausted, piece " << string_size(piece()) << ", use locked mode");
+		}
+	}
 	regist_alloter(this);
 }
 
@@ -454,6 +693,19 @@ cycle_chunk_unit(void* item)
 MemPool::~MemPool()
 {
     regist_alloter(this, false);
+	mem_governor().release(unit_charge() * (m_free.size() + m_used.size() + m_full.size()));
+
+	if (m_slot >= 0) {
+		Mutex::Locker lock(MagazineSlot::instance().mutex());
+		Magazine* mag = NULL;
+		/** piece in magazine will be cycled with unit */
+		while ((mag = (Magazine*)m_magazine.deque())) {
+			mag->m_owner = NULL;
+			mag->m_size = 0;
+		}
+		MagazineSlot::instance().free(m_slot);
+		m_slot = -1;
+	}
 	Mutex::Locker lock(m_mutex);
 
 	m_free.clear(cycle_chunk_unit);
@@ -471,10 +723,12 @@ MemPool::pop_unit()
 			m_used.del(unit);
 			m_full.enque_tail(unit);
 			trace(unit->string() << " up to full");
+			prefer_unit();
 		}
 
 	} else if (!m_free.empty()) {
 		unit = (MemUnit*)m_free.deque_tail();
+		unit->m_advised = false;
 		m_used.enque_tail(unit);
 		trace(unit->string() << " up to used");
 
@@ -486,6 +740,11 @@ MemPool::pop_unit()
 				return NULL;
 			}
 		}
+		if (!mem_governor().acquire(unit_charge())) {
+			log_info("alloc memory exceed governor hard mark " << string_size(mem_governor().hard()));
+			errno = ENOMEM;
+			return NULL;
+		}
 		if (m_config.ct_size != 0) {
 			unit = new ContainUnit(m_config);
 		} else {
@@ -513,6 +772,22 @@ MemPool::push_unit(MemUnit* unit)
 	}
 }
 
+void
+MemPool::prefer_unit()
+{
+	if (m_used.size() <= 1) {
+		return;
+	}
+	MemUnit* unit = NULL, *fullest = NULL;
+	m_used.init();
+	while ((unit = (MemUnit*)m_used.next())) {
+		if (!fullest || unit->size() < fullest->size()) {
+			fullest = unit;
+		}
+	}
+	m_used.move_tail(fullest);
+}
+
 void*
 MemPool::new_piece(size_t len)
 {
@@ -532,22 +807,149 @@ MemPool::del_piece(void* data, size_t len)
 	push_unit(unit);
 }
 
+MemPool::Magazine*
+MemPool::magazine()
+{
+	Magazine*& mag = MagazineSlot::local(m_slot);
+	if (!mag) {
+		mag = new Magazine;
+	}
+
+	/** first time used in thread, or slot reused by new pool */
+	if (mag->m_owner != this) {
+		Mutex::Locker lock(MagazineSlot::instance().mutex());
+		Mutex::Locker pool_lock(m_mutex);
+		mag->m_owner = this;
+		mag->m_size = 0;
+		m_magazine.enque(mag);
+	}
+	return mag;
+}
+
+void*
+MemPool::magazine_new(size_t len)
+{
+	Magazine* mag = magazine();
+	if (mag->empty() && !refill(mag, len)) {
+		return NULL;
+	}
+	return mag->pop();
+}
+
+void
+MemPool::magazine_del(void* data, size_t len)
+{
+	Magazine* mag = magazine();
+	if (mag->m_size >= m_config.magazine) {
+		flush(mag, std::max(m_config.magazine / 2, 1u));
+	}
+	mag->push(data);
+}
+
+bool
+MemPool::refill(Magazine* mag, size_t len)
+{
+	Mutex::Locker lock(m_mutex);
+	uint32_t count = std::max(m_config.magazine / 2, 1u);
+	void* data = NULL;
+
+	while (mag->m_size < count && (data = new_piece(len))) {
+		mag->push(data);
+	}
+	return !mag->empty();
+}
+
+void
+MemPool::flush(Magazine* mag, uint32_t count)
+{
+	Mutex::Locker lock(m_mutex);
+	while (count-- > 0 && !mag->empty()) {
+		del_piece(mag->pop());
+	}
+}
+
+void
+MemPool::detach(Magazine* mag)
+{
+	flush(mag, mag->m_size);
+
+	Mutex::Locker lock(m_mutex);
+	m_magazine.del(mag);
+	mag->m_owner = NULL;
+}
+
 void
 MemPool::release()
 {
 	Mutex::Locker lock(m_mutex);
 	MemUnit* unit = NULL;
+	int64_t reclaim = 0;
 	m_free.init();
 
 	while ((unit = (MemUnit*)m_free.next())) {
-		if (unit->timeout()) {
+		if (!unit->timeout()) {
+			continue;
+		}
+		if (m_free.size() > m_config.keep) {
 			trace("memory release, cycle " << unit->string() << ", remain " << m_free.size() - 1);
 
+			reclaim += unit->utlen();
 			m_free.del(unit);
 			delete unit;
+			mem_governor().release(unit_charge());
+
+		} else if (!unit->m_advised) {
+			trace("memory release, advise " << unit->string());
+
+			reclaim += unit->advise();
+			unit->m_advised = true;
 		}
 	}
-	trace("memory status, empty " << m_full.size() << ", used " << m_used.size() << ", free " << m_free.size());
+	prefer_unit();
+
+	if (reclaim) {
+		atomic_add64(&s_reclaimed, reclaim);
+	}
+	trace("memory status, empty " << m_full.size() << ", used " << m_used.size() << ", free " << m_free.size()
+		<< ", reclaim " << string_size(reclaim));
+}
+
+NodePool::NodePool(const MemConfig& config)
+	: BaseAlloter(config.piece)
+{
+	for (int node = 0; node < topology().nodes(); node++) {
+		MemConfig local(config);
+		local.node = node;
+		m_pools.push_back(new MemPool(local));
+	}
+}
+
+NodePool::~NodePool()
+{
+	for (auto pool : m_pools) {
+		delete pool;
+	}
+	m_pools.clear();
+}
+
+void*
+NodePool::_new(size_t len)
+{
+	return m_pools[current_node()]->_new(len);
+}
+
+void
+NodePool::_del(void* data, size_t len)
+{
+	m_pools[mem_node(data)]->_del(data, len);
+}
+
+void
+NodePool::release()
+{
+	for (auto pool : m_pools) {
+		pool->release();
+	}
 }
 
 }
@@ -560,7 +962,7 @@ namespace common {
 class RegistAlloter : public ThreadBase
 {
 public:
-	RegistAlloter() : ThreadBase(5000) {
+	RegistAlloter() : ThreadBase(memory::c_scavenge) {
 		assert(start() == 0);
 	}
 
@@ -579,6 +981,15 @@ public:
 		}
 	}
 
+	/**
+	 * set cycle interval, take effect at once
+	 **/
+	void	interval(uint32_t ms) {
+		Mutex::Locker lock(mutex());
+		set_wait(ms);
+		wakeup_unlock();
+	}
+
 	/**
 	 * release alloter
 	 **/
@@ -613,11 +1024,29 @@ regist_alloter(BaseAlloter* alloter, bool regist)
 	alloter_checker().regist_alloter(alloter, regist);
 }
 
+void
+scavenge_interval(uint32_t ms)
+{
+	alloter_checker().interval(ms);
+}
+
+void
+scavenge()
+{
+	alloter_checker().release_alloter();
+}
+
 }
 
 #if COMMON_TEST
+#include <random>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/perf_event.h>
 #include "Perform/TestUtil.hpp"
 #include "Perform/Debug.hpp"
+#include "Perform/Timer.hpp"
 
 namespace common {
     MemConfig& chunk_config(MemConfig& config);
@@ -643,6 +1072,191 @@ namespace tester {
 		batchs(10, alloter_test, &s_pool2, 1000, 50);
 		batchs(10, alloter_test, &s_pool3, 10000, 500);
 		thread_wait();
+
+		MemConfig config4(57, 16, c_length_1K);
+		config4.magazine = memory::c_magazine_len;
+		MemPool s_pool4(chunk_config(config4));
+
+		batchs(10, alloter_test, &s_pool4, 10000, 500);
+		thread_wait();
+	}
+
+	void
+	__magazine_work(BaseAlloter* alloter, int64_t count, int hold)
+	{
+		void* array[c_length_1K];
+		assert(hold <= c_length_1K);
+
+		for (int64_t i = 0; i < count; i++) {
+			for (int j = 0; j < hold; j++) {
+				array[j] = alloter->_new();
+			}
+			for (int j = 0; j < hold; j++) {
+				alloter->_del(array[j]);
+			}
+		}
+	}
+
+	void
+	mem_magazine_test()
+	{
+		const int64_t count = 10000;
+		const int hold = 16;
+
+		for (int thread = 1; thread <= 64; thread *= 2) {
+			for (int magazine : { 0, memory::c_magazine_len }) {
+				MemConfig config(c_length_1K);
+				config.magazine = magazine;
+				MemPool pool(config);
+
+				CREATE_TIMER;
+				batchs(thread, __magazine_work, &pool, count, hold);
+				thread_wait();
+
+				ctime_t time = timer.check();
+				log_info("mem pool " << (magazine ? "magazine" : "locked  ") << ", thread " << thread
+					<< ", alloc and free " << string_count(thread * count * hold)
+					<< ", ops " << string_iops(thread * count * hold * 2, time)
+					<< ", using " << string_timer(time));
+			}
+		}
+	}
+
+	/**
+	 * dtlb read miss counter of current thread, -1 if not support
+	 **/
+	class TlbCounter
+	{
+	public:
+		TlbCounter() {
+			struct perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = PERF_TYPE_HW_CACHE;
+			attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+				| (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			m_fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+		}
+
+		~TlbCounter() {
+			if (m_fd >= 0) {
+				close(m_fd);
+			}
+		}
+
+	public:
+		void	start() {
+			if (m_fd >= 0) {
+				ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+				ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+			}
+		}
+
+		int64_t	stop() {
+			int64_t count = -1;
+			if (m_fd >= 0) {
+				ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+				if (read(m_fd, &count, sizeof(count)) != sizeof(count)) {
+					count = -1;
+				}
+			}
+			return count;
+		}
+
+	protected:
+		int 	m_fd = { -1 };
+	};
+
+	void
+	mem_page_test()
+	{
+		const int total = 256 * c_length_1M;
+		const int piece = c_length_4K;
+		const int count = total / piece;
+		const int64_t touch = 10000000;
+
+		std::vector<void*> array(count);
+		for (uint32_t page : { PG_normal, PG_transparent, PG_huge }) {
+			MemConfig config(piece, c_align, 32 * c_length_1M);
+			config.page = page;
+			MemPool pool(config);
+
+			for (auto& data : array) {
+				data = pool._new();
+				memset(data, 0, piece);
+			}
+			std::shuffle(array.begin(), array.end(), std::mt19937(rand()));
+
+			TlbCounter counter;
+			CREATE_TIMER;
+			counter.start();
+			for (int64_t i = 0; i < touch; i++) {
+				/** random piece, touch one of its cache lines */
+				(*(volatile byte_t*)((byte_t*)array[i % count] + (i & 63) * 64))++;
+			}
+			int64_t miss = counter.stop();
+			ctime_t time = timer.check();
+
+			log_info("mem page " << (page == PG_normal ? "normal     " : page == PG_huge ? "huge       " : "transparent")
+				<< ", touch " << string_count(touch) << ", latency " << (double)time * 1000 / touch << " ns"
+				<< ", dtlb miss " << (miss < 0 ? std::string("n/a") : string_count(miss))
+				<< ", using " << string_timer(time));
+
+			for (auto data : array) {
+				pool._del(data);
+			}
+		}
+
+		/** node pool, each thread alloc on its node */
+		MemConfig config(piece);
+		NodePool node(config);
+		batchs(4, alloter_test, &node, 10000, 500);
+		thread_wait();
+		log_info("mem node pool, node count " << node.size());
+	}
+
+	void
+	mem_scavenge_test()
+	{
+		const int count = 512;
+		MemConfig config(c_length_64K, c_align, 4 * c_length_1M);
+		config.timeout = 100;
+		config.keep = 1;
+		MemPool pool(config);
+
+		std::vector<void*> array(count);
+		for (auto& data : array) {
+			data = pool._new();
+			memset(data, 1, c_length_64K);
+		}
+		/** free in random order, unit drain by prefer fullest */
+		std::shuffle(array.begin(), array.end(), std::mt19937(rand()));
+		for (int i = 0; i < count / 2; i++) {
+			pool._del(array[i]);
+		}
+		for (int i = 0; i < count / 2; i++) {
+			array[i] = pool._new();
+		}
+		for (auto data : array) {
+			pool._del(data);
+		}
+
+		int64_t reclaim = mem_reclaimed();
+		scavenge_interval(50);
+		usleep(300 * c_time_level[0]);
+		scavenge_interval();
+
+		/** free units, only one kept and advised */
+		success(mem_reclaimed() > reclaim);
+		log_info("mem scavenge, reclaim " << string_size(mem_reclaimed() - reclaim));
+
+		/** advised unit reused, page refault */
+		void* data = pool._new();
+		memset(data, 2, c_length_64K);
+		pool._del(data);
 	}
 }
 }
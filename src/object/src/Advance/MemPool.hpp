@@ -2,10 +2,12 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "Common/Define.hpp"
 #include "Common/Mutex.hpp"
 #include "Advance/List.hpp"
+#include "Advance/MemAccount.hpp"
 #include "Advance/BaseAlloter.hpp"
 
 namespace common {
@@ -27,6 +29,28 @@ namespace common {
 		static const int64_t c_magic = 0xFF56879LL;
         /** unit timeout for free */
         static const int c_timeout  = 10000;
+        /** default piece count kept in thread magazine */
+        static const int c_magazine_len = 32;
+        /** max piece count kept in thread magazine */
+        static const int c_magazine_max = 256;
+        /** max pool count using thread magazine */
+        static const int c_magazine_pool = 64;
+        /** default scavenge interval */
+        static const int c_scavenge = 5000;
+        /** huge page length */
+        static const int c_huge_len = 2 * c_length_1M;
+
+        /**
+         * unit backing page type
+         **/
+        enum PageType {
+        	/** plain heap memory */
+        	PG_normal = 0,
+        	/** mmap with transparent huge page advise */
+        	PG_transparent,
+        	/** mmap with explicit huge page, fallback to transparent */
+        	PG_huge,
+        };
 	}
 
 	/**
@@ -65,6 +89,12 @@ namespace common {
 
             ct_size = v.ct_size;
             ct_off = v.ct_off;
+            magazine = v.magazine;
+            tag = v.tag;
+            page = v.page;
+            node = v.node;
+            keep = v.keep;
+            account = v.account;
 			return *this;
 		}
 
@@ -126,6 +156,18 @@ namespace common {
 		uint32_t ct_size = { 0 };
 		/** memory unit for container position */
 		uint32_t ct_off = { 0 };
+		/** thread magazine piece count, 0 for disable */
+		uint32_t magazine = { 0 };
+		/** tag kept in piece head, used by upper alloter */
+		uint32_t tag = { 0 };
+		/** unit backing page type */
+		uint32_t page = { memory::PG_normal };
+		/** numa node for unit memory, -1 for any */
+		int		 node = { -1 };
+		/** timeout free unit kept with pages advised, others will be freed */
+		uint32_t keep = { 0 };
+		/** memory account type */
+		uint32_t account = { account::AT_none };
 	};
 
     class MemUnit;
@@ -146,8 +188,18 @@ namespace common {
 		 * @note if exceed limit will failed
 		 **/
 		virtual void* _new(size_t len = 0) {
-			Mutex::Locker lock(m_mutex);
-			return new_piece(len);
+			void* data = NULL;
+			if (m_slot >= 0) {
+				data = magazine_new(len);
+
+			} else {
+				Mutex::Locker lock(m_mutex);
+				data = new_piece(len);
+			}
+			if (data) {
+				mem_account(m_account, m_config.piece);
+			}
+			return data;
 		}
 
 		/**
@@ -156,6 +208,10 @@ namespace common {
 		 * @param len unused most times
 		 */
 		virtual void  _del(void* data, size_t len = 0) {
+			mem_account(m_account, -(int64_t)m_config.piece);
+			if (m_slot >= 0) {
+				return magazine_del(data, len);
+			}
 			Mutex::Locker lock(m_mutex);
 			del_piece(data, len);
 		}
@@ -170,6 +226,8 @@ namespace common {
 		 **/
 		MemConfig*	config() { return &m_config; }
 
+		struct Magazine;
+
 	protected:
 		/**
 		 * pop a unit with chunk
@@ -181,6 +239,16 @@ namespace common {
 		 **/
 		void 	push_unit(MemUnit* unit);
 
+		/**
+		 * move the fullest used unit to tail, nearly-empty ones drain
+		 **/
+		void	prefer_unit();
+
+		/**
+		 * unit length charged to governor, container unit has out of band buffer
+		 **/
+		int64_t	unit_charge() { return (int64_t)m_config.utlen * (m_config.ct_size != 0 ? 2 : 1); }
+
 		/**
 		 * alloc new piece
 		 **/
@@ -191,6 +259,39 @@ namespace common {
 		 **/
 		void	del_piece(void* data, size_t len = 0);
 
+	protected:
+		/**
+		 * get thread magazine, attach to pool if not yet
+		 **/
+		Magazine* magazine();
+
+		/**
+		 * alloc piece from thread magazine, refill in batch if empty
+		 **/
+		void*	magazine_new(size_t len = 0);
+
+		/**
+		 * put piece to thread magazine, flush in batch if full
+		 **/
+		void	magazine_del(void* data, size_t len = 0);
+
+		/**
+		 * refill magazine from unit list
+		 **/
+		bool	refill(Magazine* mag, size_t len = 0);
+
+		/**
+		 * flush magazine piece back to unit list
+		 **/
+		void	flush(Magazine* mag, uint32_t count);
+
+		/**
+		 * detach magazine from pool, return all piece
+		 **/
+		void	detach(Magazine* mag);
+
+		template<class, int> friend class CacheSlot;
+
 	protected:
 		Mutex		m_mutex;
 		/** unit config */
@@ -201,6 +302,55 @@ namespace common {
 		List		m_used;
 		/** full list */
 		List		m_full;
+		/** thread magazine list */
+		List		m_magazine;
+		/** thread magazine slot, -1 for disable */
+		int			m_slot = { -1 };
+	};
+
+	/**
+	 * numa node pool set, alloc from pool of current thread node
+	 *
+	 * @note piece can be freed on any thread, it return to pool of its unit
+	 **/
+	class NodePool : public BaseAlloter
+	{
+	public:
+		NodePool(const MemConfig& config);
+
+		virtual ~NodePool();
+
+	public:
+		/**
+		 * alloc new chunk from current node
+		 **/
+		virtual void* _new(size_t len = 0);
+
+		/**
+		 * @brief del unused, back to the node it belongs
+		 * @param data chunk address
+		 * @param len unused most times
+		 */
+		virtual void  _del(void* data, size_t len = 0);
+
+		/**
+		 * release resource timely
+		 **/
+		virtual void release();
+
+		/**
+		 * get pool of node
+		 **/
+		MemPool* pool(int node) { return m_pools[node]; }
+
+		/**
+		 * node count
+		 **/
+		int		size() { return (int)m_pools.size(); }
+
+	protected:
+		/** pool for each node */
+		std::vector<MemPool*> m_pools;
 	};
 
 	/**
@@ -208,9 +358,46 @@ namespace common {
 	 **/
 	uint32_t mem_piece(const void* ptr);
 
+	/**
+	 * get numa node of piece unit, -1 for any
+	 **/
+	int		mem_node(const void* ptr);
+
+	/**
+	 * get piece head tag from data
+	 **/
+	uint32_t mem_tag(const void* ptr);
+
+	/**
+	 * get piece head length
+	 **/
+	uint32_t mem_head();
+
+	/**
+	 * format raw memory as piece with tag, return piece data
+	 *
+	 * @note piece not belong to any unit, mem_piece is invalid
+	 **/
+	void*	mem_wrap(void* ptr, uint32_t tag);
+
 	/**
 	 * add alloter to memory cycle
 	 **/
 	void	regist_alloter(BaseAlloter* alloter, bool regist = true);
+
+	/**
+	 * set memory cycle interval, in ms
+	 **/
+	void	scavenge_interval(uint32_t ms = memory::c_scavenge);
+
+	/**
+	 * do memory cycle at once
+	 **/
+	void	scavenge();
+
+	/**
+	 * total bytes reclaimed by memory cycle
+	 **/
+	int64_t	mem_reclaimed();
 }
 
@@ -0,0 +1,154 @@
+
+#include <cstdlib>
+
+#include "Common/Atomic.hpp"
+#include "Advance/MemResource.hpp"
+#include "Advance/SlabAlloter.hpp"
+
+namespace common {
+
+void*
+MemResource::allocate(size_t len, size_t align)
+{
+	void* data = NULL;
+	if (pooled(len, align)) {
+		data = m_alloter->_new(len);
+
+	} else if (align <= alignof(std::max_align_t)) {
+		data = ::malloc(len);
+
+	} else {
+		data = aligned_alloc(align, (len + align - 1) / align * align);
+	}
+	if (!data) {
+		throw std::bad_alloc();
+	}
+
+	int64_t used = atomic_add64(&m_used, len) + len;
+	/** peak not exactly when concurrent */
+	if (used > m_peak) {
+		m_peak = used;
+	}
+	at_inc64(m_count);
+	return data;
+}
+
+void
+MemResource::deallocate(void* data, size_t len, size_t align)
+{
+	if (pooled(len, align)) {
+		m_alloter->_del(data, len);
+
+	} else {
+		::free(data);
+	}
+	atomic_add64(&m_used, -(int64_t)len);
+	at_dec64(m_count);
+}
+
+MemResource*
+default_resource()
+{
+	static MemResource s_default_resource(slab_alloter());
+	return &s_default_resource;
+}
+}
+
+#if COMMON_TEST
+#include "Common/LogHelper.hpp"
+#include "Common/Display.hpp"
+#include "Advance/Arena.hpp"
+#include "Advance/MemPool.hpp"
+#include "Advance/SlabAlloter.hpp"
+#include "Perform/Timer.hpp"
+
+namespace common {
+namespace tester {
+
+	template<class Map>
+	void	__resource_map_work(Map& map, int count) {
+		for (int i = 0; i < count; i++) {
+			success(map.add(i, i * 2));
+		}
+		for (int i = 0; i < count; i++) {
+			success(*map.get(i) == i * 2);
+			success(map.del(i));
+		}
+	}
+
+	void
+	mem_resource_test()
+	{
+		const int count = 100000;
+		do {
+			MemPool pool(MemConfig(64));
+			MemResource resource(&pool);
+			ResourceMap<int, int> map(&resource);
+			for (int i = 0; i < count; i++) {
+				success(map.add(i, i));
+			}
+			/** one node each, all in pool piece */
+			success(resource.count() == count && pool.piece() >= (size_t)resource.used() / count);
+			log_info("resource map, " << count << " node, footprint " << string_size(resource.used())
+				<< ", peak " << string_size(resource.peak()));
+			map.clear();
+			success(resource.used() == 0 && resource.count() == 0);
+
+			ResourceSet<int> set(&resource);
+			for (int i = 0; i < 1000; i++) {
+				success(set.add(i));
+			}
+			success(set.size() == 1000 && resource.count() == 1000);
+		} while (0);
+
+		do {
+			/** length vary, use slab and arena */
+			MemResource slab(slab_alloter());
+			ResourceString string("resource string longer than inner buffer", &slab);
+			for (int i = 0; i < 10; i++) {
+				string += string;
+			}
+			success(string.length() > 10000 && slab.used() >= (int64_t)string.length());
+
+			/** container without resource use default one, on slab */
+			ResourceString other("default resource string longer than inner buffer");
+			success(default_resource()->alloter() == slab_alloter() && default_resource()->count() > 0);
+
+			Arena arena;
+			MemResource local(&arena);
+			ResourceQueue<int64_t> queue(&local);
+			for (int64_t i = 0; i < count; i++) {
+				queue.enque(i);
+			}
+			for (int64_t i = 0; i < count; i++) {
+				success(queue.deque() == i);
+			}
+			log_info("resource queue on arena, footprint " << string_size(arena.used())
+				<< ", blocks " << arena.blocks());
+		} while (0);
+
+		for (int loop = 0; loop < 2; loop++) {
+			do {
+				TypeMap<int, int> map;
+				CREATE_TIMER;
+				__resource_map_work(map, count);
+				ctime_t time = timer.check();
+				log_info("type map, malloc,   " << string_iops(count * 2, time) << " ops/s");
+			} while (0);
+
+			do {
+				MemConfig config(64);
+				config.magazine = memory::c_magazine_len;
+				MemPool pool(config);
+				MemResource resource(&pool);
+				ResourceMap<int, int> map(&resource);
+				CREATE_TIMER;
+				__resource_map_work(map, count);
+				ctime_t time = timer.check();
+				log_info("type map, mem pool, " << string_iops(count * 2, time) << " ops/s");
+			} while (0);
+		}
+	}
+}
+}
+#endif
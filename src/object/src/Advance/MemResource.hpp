@@ -0,0 +1,188 @@
+
+#pragma once
+
+#include <new>
+#include <string>
+#include <cstddef>
+#if __cplusplus >= 201703L
+#include <memory_resource>
+#endif
+
+#include "Common/Define.hpp"
+#include "Common/TypeQueue.hpp"
+#include "Common/Container.hpp"
+#include "Advance/BaseAlloter.hpp"
+
+namespace common {
+
+	/**
+	 * memory resource over BaseAlloter, for container allocator
+	 *
+	 * @note length not exceed alloter piece go to alloter, others go to malloc;
+	 * 		 pool piece is its object length, slab piece is its max class length,
+	 * 		 arena piece is its block length; zero piece accept any length;
+	 * 		 work as std::pmr::memory_resource when build with c++17
+	 **/
+	class MemResource
+	#if __cplusplus >= 201703L
+		: public std::pmr::memory_resource
+	#endif
+	{
+	public:
+		/**
+		 * @param alloter origin alloter, malloc only if null
+		 **/
+		MemResource(BaseAlloter* alloter = NULL) : m_alloter(alloter) {}
+
+		virtual ~MemResource() {}
+
+	public:
+		/**
+		 * alloc len, throw bad_alloc if failed
+		 **/
+		void*	allocate(size_t len, size_t align = alignof(std::max_align_t));
+
+		/**
+		 * free data alloc by allocate with the same len
+		 **/
+		void	deallocate(void* data, size_t len, size_t align = alignof(std::max_align_t));
+
+		/**
+		 * resource is equal only if the same one
+		 **/
+		bool	equal(const MemResource& other) const { return this == &other; }
+
+	public:
+		/**
+		 * get origin alloter
+		 **/
+		BaseAlloter* alloter() { return m_alloter; }
+
+		/**
+		 * current alloc length
+		 **/
+		int64_t	used() { return m_used; }
+
+		/**
+		 * max alloc length
+		 **/
+		int64_t	peak() { return m_peak; }
+
+		/**
+		 * current alloc count
+		 **/
+		int64_t	count() { return m_count; }
+
+	protected:
+		/**
+		 * check if len alloc from alloter
+		 **/
+		bool	pooled(size_t len, size_t align) {
+			return m_alloter && align <= alignof(std::max_align_t) &&
+				(m_alloter->piece() == 0 || len <= m_alloter->piece());
+		}
+
+	#if __cplusplus >= 201703L
+		virtual void* do_allocate(size_t len, size_t align) override {
+			return allocate(len, align);
+		}
+
+		virtual void do_deallocate(void* data, size_t len, size_t align) override {
+			deallocate(data, len, align);
+		}
+
+		virtual bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+			return this == &other;
+		}
+	#endif
+
+	protected:
+		/** origin alloter */
+		BaseAlloter* m_alloter = { NULL };
+		/** alloc length */
+		volatile int64_t m_used = { 0 };
+		/** max alloc length */
+		volatile int64_t m_peak = { 0 };
+		/** alloc count */
+		volatile int64_t m_count = { 0 };
+	};
+
+	/**
+	 * default resource, length in size class go to slab_alloter, others malloc
+	 **/
+	MemResource* default_resource();
+
+	/**
+	 * container allocator using MemResource, like std::pmr::polymorphic_allocator
+	 **/
+	template<class Type>
+	class ResourceAllocator
+	{
+	public:
+		typedef Type value_type;
+
+		ResourceAllocator(MemResource* resource = default_resource())
+			: m_resource(resource) {}
+
+		template<class Other>
+		ResourceAllocator(const ResourceAllocator<Other>& other)
+			: m_resource(other.resource()) {}
+
+	public:
+		/**
+		 * alloc n type
+		 **/
+		Type*	allocate(size_t n) {
+			return (Type*)m_resource->allocate(n * sizeof(Type), alignof(Type));
+		}
+
+		/**
+		 * free n type
+		 **/
+		void	deallocate(Type* data, size_t n) {
+			m_resource->deallocate(data, n * sizeof(Type), alignof(Type));
+		}
+
+		/**
+		 * get resource
+		 **/
+		MemResource* resource() const { return m_resource; }
+
+		template<class Other>
+		bool	operator == (const ResourceAllocator<Other>& other) const {
+			return m_resource->equal(*other.resource());
+		}
+
+		template<class Other>
+		bool	operator != (const ResourceAllocator<Other>& other) const {
+			return !(*this == other);
+		}
+
+	protected:
+		/** memory resource */
+		MemResource* m_resource = { NULL };
+	};
+
+	/**
+	 * containers alloc from resource
+	 **/
+	template<class Type, class Comp = std::less<Type> >
+	using ResourceSet = TypeSet<Type, Comp, ResourceAllocator<Type> >;
+
+	template<class Key, class Type, class Comp = std::less<Key> >
+	using ResourceMap = TypeMap<Key, Type, Comp, ResourceAllocator<std::pair<const Key, Type> > >;
+
+	template<class Type>
+	using ResourceQueue = TypeQueue<Type, ResourceAllocator<Type> >;
+
+	typedef std::basic_string<char, std::char_traits<char>, ResourceAllocator<char> > ResourceString;
+}
+
+#if COMMON_SPACE
+	using common::MemResource;
+	using common::ResourceAllocator;
+	using common::ResourceSet;
+	using common::ResourceMap;
+	using common::ResourceQueue;
+	using common::ResourceString;
+#endif
@@ -1,4 +1,7 @@
 
+#include <cstring>
+#include <immintrin.h>
+
 #include "Common/Type.hpp"
 #include "Advance/ByteOrder.hpp"
 
@@ -19,4 +22,111 @@ namespace common {
 		}
 	}
 
+	void
+	swap_array_scalar(void* dst, const void* src, int size, length_t count) {
+		switch (size) {
+		case 2:
+			for (length_t i = 0; i < count; i++) {
+				((uint16_t*)dst)[i] = __builtin_bswap16(((const uint16_t*)src)[i]);
+			}
+			break;
+		case 4:
+			for (length_t i = 0; i < count; i++) {
+				((uint32_t*)dst)[i] = __builtin_bswap32(((const uint32_t*)src)[i]);
+			}
+			break;
+		case 8:
+			for (length_t i = 0; i < count; i++) {
+				((uint64_t*)dst)[i] = __builtin_bswap64(((const uint64_t*)src)[i]);
+			}
+			break;
+		default:
+			if (dst != src) {
+				memcpy(dst, src, (size_t)size * count);
+			}
+			break;
+		}
+	}
+
+	/** shuffle mask reverse byte of each int, for 2, 4 and 8 byte int */
+	static const byte_t c_swap_mask[3][16] = {
+		{ 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14 },
+		{ 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 },
+		{ 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8 },
+	};
+
+	static int
+	swap_mask(int size) {
+		return size == 2 ? 0 : (size == 4 ? 1 : 2);
+	}
+
+	__attribute__((target("ssse3"))) static void
+	swap_array_ssse3(void* dst, const void* src, int size, length_t count) {
+		if (size != 2 && size != 4 && size != 8) {
+			swap_array_scalar(dst, src, size, count);
+			return;
+		}
+		__m128i mask = _mm_loadu_si128((const __m128i*)c_swap_mask[swap_mask(size)]);
+		size_t total = (size_t)size * count;
+		size_t pos = 0;
+		for (; pos + 16 <= total; pos += 16) {
+			__m128i value = _mm_loadu_si128((const __m128i*)((const byte_t*)src + pos));
+			_mm_storeu_si128((__m128i*)((byte_t*)dst + pos), _mm_shuffle_epi8(value, mask));
+		}
+		swap_array_scalar((byte_t*)dst + pos, (const byte_t*)src + pos, size, (total - pos) / size);
+	}
+
+	__attribute__((target("avx2"))) static void
+	swap_array_avx2(void* dst, const void* src, int size, length_t count) {
+		if (size != 2 && size != 4 && size != 8) {
+			swap_array_scalar(dst, src, size, count);
+			return;
+		}
+		__m128i half = _mm_loadu_si128((const __m128i*)c_swap_mask[swap_mask(size)]);
+		__m256i mask = _mm256_broadcastsi128_si256(half);
+		size_t total = (size_t)size * count;
+		size_t pos = 0;
+		for (; pos + 32 <= total; pos += 32) {
+			__m256i value = _mm256_loadu_si256((const __m256i*)((const byte_t*)src + pos));
+			_mm256_storeu_si256((__m256i*)((byte_t*)dst + pos), _mm256_shuffle_epi8(value, mask));
+		}
+		swap_array_ssse3((byte_t*)dst + pos, (const byte_t*)src + pos, size, (total - pos) / size);
+	}
+
+	typedef void (*swap_array_t)(void* dst, const void* src, int size, length_t count);
+
+	/** swap kernel name */
+	static const char* s_swap_kernel = "scalar";
+
+	/**
+	 * choose swap kernel by cpu, only once
+	 **/
+	static swap_array_t
+	swap_select() {
+		static swap_array_t s_swap_array = []() -> swap_array_t {
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2")) {
+				s_swap_kernel = "avx2";
+				return swap_array_avx2;
+
+			} else if (__builtin_cpu_supports("ssse3")) {
+				s_swap_kernel = "ssse3";
+				return swap_array_ssse3;
+			}
+			return swap_array_scalar;
+		}();
+		return s_swap_array;
+	}
+
+	void
+	swap_array(void* dst, const void* src, int size, length_t count) {
+		swap_select()(dst, src, size, count);
+	}
+
+	const char*
+	swap_kernel() {
+		swap_select();
+		return s_swap_kernel;
+	}
+
 }
@@ -0,0 +1,224 @@
+
+#define LOG_CODE 0
+
+#include <cstdlib>
+#include <malloc.h>
+
+#include "Common/LogHelper.hpp"
+#include "Common/Display.hpp"
+#include "Advance/Util.hpp"
+#include "Advance/MemPool.hpp"
+#include "Advance/SlabAlloter.hpp"
+
+namespace common {
+
+SlabAlloter::SlabAlloter(uint32_t max, uint32_t growth, uint32_t magazine, uint64_t limit)
+	: BaseAlloter(max), m_max(up_align(std::max(max, (uint32_t)slab::c_min_len), slab::c_align))
+{
+	init(growth, magazine, limit);
+}
+
+SlabAlloter::~SlabAlloter()
+{
+	for (auto pool : m_pools) {
+		delete pool;
+	}
+	m_pools.clear();
+}
+
+void
+SlabAlloter::init(uint32_t growth, uint32_t magazine, uint64_t limit)
+{
+	/** geometric class length, each class grow at least one align unit */
+	uint32_t length = slab::c_min_len;
+	while (length < m_max) {
+		m_class.push_back(length);
+		uint32_t next = up_align(length + length * growth / 100, slab::c_align);
+		length = std::max(next, length + slab::c_align);
+	}
+	m_class.push_back(m_max);
+	/** class index kept in uint8_t and piece tag */
+	assert(m_class.size() < 256);
+
+	m_index.resize(m_max / slab::c_align + 1);
+	size_t index = 0;
+	for (size_t i = 0; i < m_index.size(); i++) {
+		if (i * slab::c_align > m_class[index]) {
+			index++;
+		}
+		m_index[i] = (uint8_t)index;
+	}
+
+	for (size_t i = 0; i < m_class.size(); i++) {
+		/** keep unit hold enough piece, but not too large for small class */
+		uint32_t utlen = std::min(std::max(m_class[i] * slab::c_unit_count,
+			(uint32_t)c_length_1M), (uint32_t)memory::c_unit_len);
+
+		MemConfig config(m_class[i], slab::c_align, utlen, limit);
+		config.magazine = magazine;
+		/** tag 0 is kept for piece not belong to us */
+		config.tag = i + 1;
+		m_pools.push_back(new MemPool(config));
+	}
+	trace("slab alloter, class " << m_class.size() << ", max " << string_size(m_max));
+}
+
+void*
+SlabAlloter::_new(size_t len)
+{
+	int index = this->index(len);
+	if (index >= 0) {
+		void* data = m_pools[index]->_new(len);
+		if (data) {
+			mem_account(m_account, m_class[index]);
+		}
+		return data;
+	}
+
+	void* ptr = ::malloc(mem_head() + len);
+	if (!ptr) {
+		return NULL;
+	}
+	mem_account(m_account, malloc_usable_size(ptr));
+	return mem_wrap(ptr, slab::c_large_tag);
+}
+
+void
+SlabAlloter::_del(void* data, size_t len)
+{
+	if (!data) {
+		return;
+	}
+	uint32_t tag = mem_tag(data);
+	if (tag == slab::c_large_tag) {
+		void* ptr = (byte_t*)data - mem_head();
+		mem_account(m_account, -(int64_t)malloc_usable_size(ptr));
+		::free(ptr);
+
+	} else {
+		assert(tag > 0 && tag <= m_pools.size());
+		mem_account(m_account, -(int64_t)m_class[tag - 1]);
+		m_pools[tag - 1]->_del(data, len);
+	}
+}
+
+void
+SlabAlloter::release()
+{
+	for (auto pool : m_pools) {
+		pool->release();
+	}
+}
+
+size_t
+SlabAlloter::usable(const void* data)
+{
+	uint32_t tag = mem_tag(data);
+	if (tag == slab::c_large_tag) {
+		return malloc_usable_size((byte_t*)data - mem_head()) - mem_head();
+	}
+	return m_class[tag - 1];
+}
+
+SlabAlloter*
+slab_alloter()
+{
+	static SlabAlloter s_slab_alloter;
+	return &s_slab_alloter;
+}
+}
+
+#if COMMON_TEST
+#include <cstring>
+
+#include "Perform/Debug.hpp"
+#include "Perform/Timer.hpp"
+
+namespace common {
+namespace tester {
+
+	void
+	__slab_work(BaseAlloter* alloter, int64_t count, uint32_t max, bool check)
+	{
+		const int hold = 64;
+		void*  array[hold] = {NULL};
+		size_t length[hold] = {0};
+
+		for (int64_t i = 0; i < count; i++) {
+			int pos = random() % hold;
+			if (array[pos]) {
+				if (check) {
+					byte_t* data = (byte_t*)array[pos];
+					for (size_t j = 0; j < length[pos]; j += 64) {
+						success(data[j] == (byte_t)pos);
+					}
+				}
+				alloter->_del(array[pos], length[pos]);
+			}
+			/** bias to small length, as most request */
+			length[pos] = random() % (random() % 4 == 0 ? max : 256) + 1;
+			array[pos] = alloter->_new(length[pos]);
+			success(array[pos] != NULL);
+			if (check) {
+				memset(array[pos], pos, length[pos]);
+			}
+		}
+		for (int pos = 0; pos < hold; pos++) {
+			alloter->_del(array[pos], length[pos]);
+		}
+	}
+
+	/**
+	 * malloc wrapper, compare with slab
+	 **/
+	class MallocAlloter : public BaseAlloter
+	{
+	public:
+		virtual void* _new(size_t len = 0) { return ::malloc(len); }
+		virtual void  _del(void* data, size_t len = 0) { ::free(data); }
+	};
+
+	void
+	slab_alloter_test()
+	{
+		SlabAlloter slab;
+		/** every length fit in its class */
+		for (size_t len = 0; len <= slab::c_max_len; len++) {
+			int index = slab.index(len);
+			success(index >= 0 && slab.length(index) >= len);
+			success(index == 0 || slab.length(index - 1) < len);
+		}
+		success(slab.index(slab::c_max_len + 1) == -1);
+
+		void* data = slab._new(100);
+		success(slab.usable(data) >= 100);
+		slab._del(data);
+		data = slab._new(slab::c_max_len * 2);
+		success(slab.usable(data) >= slab::c_max_len * 2);
+		slab._del(data);
+
+		check_memory(true);
+		set_random();
+		batchs(10, __slab_work, &slab, 100000, slab::c_max_len * 2, true);
+		thread_wait();
+
+		const int64_t count = 200000;
+		SlabAlloter magazine(slab::c_max_len, slab::c_growth, memory::c_magazine_len);
+		MallocAlloter origin;
+
+		for (int thread = 1; thread <= 16; thread *= 4) {
+			for (BaseAlloter* alloter : std::initializer_list<BaseAlloter*>{ &slab, &magazine, &origin }) {
+				CREATE_TIMER;
+				batchs(thread, __slab_work, alloter, count, slab::c_max_len, false);
+				thread_wait();
+
+				ctime_t time = timer.check();
+				log_info("slab alloter " << (alloter == &slab ? "locked  " : alloter == &magazine ? "magazine" : "malloc  ")
+					<< ", thread " << thread << ", ops " << string_iops(thread * count * 2, time)
+					<< ", using " << string_timer(time));
+			}
+		}
+	}
+}
+}
+#endif
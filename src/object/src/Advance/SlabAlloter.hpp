@@ -0,0 +1,109 @@
+
+#pragma once
+
+#include <vector>
+
+#include "Common/Const.hpp"
+#include "Common/Define.hpp"
+#include "Advance/BaseAlloter.hpp"
+
+namespace common {
+
+	namespace slab {
+		/** min size class length */
+		static const int c_min_len	= 16;
+		/** default max size class length */
+		static const int c_max_len	= 64 * c_length_1K;
+		/** size class align, also piece data align */
+		static const int c_align	= 16;
+		/** default growth between size class, percent */
+		static const int c_growth	= 25;
+		/** piece count for each unit, adjust unit length */
+		static const int c_unit_count = 128;
+		/** piece tag for large alloc, out of size class */
+		static const uint32_t c_large_tag = 0xFFFF;
+	}
+
+	class MemPool;
+	/**
+	 * size class alloter, route request length to geometric size class pool
+	 *
+	 * @note piece head tag keep class index, so _del need no length;
+	 * 		 request larger than max class will use malloc directly
+	 **/
+	class SlabAlloter : public BaseAlloter
+	{
+	public:
+		SlabAlloter(uint32_t max = slab::c_max_len, uint32_t growth = slab::c_growth,
+			uint32_t magazine = 0, uint64_t limit = 0);
+
+		virtual ~SlabAlloter();
+
+	public:
+		/**
+		 * alloc piece can hold len
+		 **/
+		virtual void* _new(size_t len = 0);
+
+		/**
+		 * @brief del piece, class is recovered from piece head
+		 * @param data piece address
+		 * @param len unused
+		 */
+		virtual void  _del(void* data, size_t len = 0);
+
+		/**
+		 * release resource timely
+		 **/
+		virtual void release();
+
+	public:
+		/**
+		 * size class count
+		 **/
+		size_t	size() { return m_class.size(); }
+
+		/**
+		 * get size class length
+		 **/
+		uint32_t length(int index) { return m_class[index]; }
+
+		/**
+		 * get size class index for request length, -1 for large
+		 **/
+		int		index(size_t len) {
+			return len > m_max ? -1
+				: m_index[(len + slab::c_align - 1) / slab::c_align];
+		}
+
+		/**
+		 * get piece usable length
+		 **/
+		size_t	usable(const void* data);
+
+	protected:
+		/**
+		 * init size class and pools
+		 **/
+		void	init(uint32_t growth, uint32_t magazine, uint64_t limit);
+
+	protected:
+		/** max class length */
+		uint32_t m_max = { 0 };
+		/** size class length */
+		std::vector<uint32_t> m_class;
+		/** align unit to class index */
+		std::vector<uint8_t>  m_index;
+		/** class pools */
+		std::vector<MemPool*> m_pools;
+	};
+
+	/**
+	 * global size class alloter
+	 **/
+	SlabAlloter* slab_alloter();
+}
+
+#if COMMON_SPACE
+	using common::SlabAlloter;
+#endif
@@ -0,0 +1,157 @@
+
+#pragma once
+
+#include <vector>
+
+#include "Common/Define.hpp"
+#include "Common/Atomic.hpp"
+
+namespace common
+{
+	/**
+	 * work stealing deque (chase-lev), owner push and pop at bottom, lifo;
+	 * others steal at top, fifo
+	 *
+	 * @note only owner thread call push and pop, steal can call by any thread;
+	 * 		 array grow by owner when full, old array kept until deque destroy,
+	 * 		 for thief may still read it
+	 * @note bottom and array publish by release store, thief load acquire;
+	 * 		 pop need full fence between bottom store and top load
+	 */
+	template<class T>
+	class StealDeque
+	{
+	public:
+		StealDeque(int64_t size = 256) {
+			int64_t total = 1;
+			while (total < size) {
+				total <<= 1;
+			}
+			m_array = new Array(total);
+		}
+
+		~StealDeque() {
+			delete m_array;
+			for (auto array : m_retire) {
+				delete array;
+			}
+		}
+
+	public:
+		/**
+		 * push data at bottom, owner only
+		 **/
+		void	push(T* data) {
+			int64_t bottom = m_bottom;
+			int64_t top = m_top;
+			Array* array = m_array;
+			if (bottom - top > array->mask) {
+				array = grow(array, bottom, top);
+			}
+			array->put(bottom, data);
+			/** slot store visible before bottom */
+			atomic_store_release(&m_bottom, bottom + 1);
+		}
+
+		/**
+		 * pop data at bottom, owner only, NULL if empty
+		 **/
+		T*		pop() {
+			int64_t bottom = m_bottom - 1;
+			Array* array = m_array;
+			atomic_store_release(&m_bottom, bottom);
+			/** bottom store visible before read top, pair with thief */
+			atomic_fence();
+			int64_t top = atomic_load_acquire(&m_top);
+
+			if (top > bottom) {
+				atomic_store_release(&m_bottom, bottom + 1);
+				return NULL;
+			}
+			T* data = array->get(bottom);
+			if (top == bottom) {
+				/** last one, race with thief */
+				if (atomic_comp_swap64(&m_top, top + 1, top) != top) {
+					data = NULL;
+				}
+				atomic_store_release(&m_bottom, bottom + 1);
+			}
+			return data;
+		}
+
+		/**
+		 * steal data at top, NULL if empty or lost race with others
+		 **/
+		T*		steal() {
+			int64_t top = atomic_load_acquire(&m_top);
+			int64_t bottom = atomic_load_acquire(&m_bottom);
+			if (top >= bottom) {
+				return NULL;
+			}
+			T* data = atomic_load_acquire(&m_array)->get(top);
+			if (atomic_comp_swap64(&m_top, top + 1, top) != top) {
+				return NULL;
+			}
+			return data;
+		}
+
+		/**
+		 * get data count, not exactly when concurrent
+		 **/
+		int64_t	size() const {
+			int64_t size = atomic_load_acquire(&m_bottom) - atomic_load_acquire(&m_top);
+			return size > 0 ? size : 0;
+		}
+
+		/**
+		 * check if empty
+		 **/
+		bool	empty() const { return size() == 0; }
+
+	protected:
+		/**
+		 * cycle array, position is counter & mask
+		 **/
+		struct Array
+		{
+			Array(int64_t size)
+				: mask(size - 1), slot(size, NULL) {}
+
+			T*		get(int64_t pos) const { return slot[pos & mask]; }
+
+			void	put(int64_t pos, T* data) { slot[pos & mask] = data; }
+
+			int64_t	mask;
+			std::vector<T*> slot;
+		};
+
+		/**
+		 * double array, copy data not stolen
+		 **/
+		Array*	grow(Array* array, int64_t bottom, int64_t top) {
+			Array* next = new Array((array->mask + 1) * 2);
+			for (int64_t pos = top; pos < bottom; pos++) {
+				next->put(pos, array->get(pos));
+			}
+			m_retire.push_back(array);
+			/** copy visible before thief see new array */
+			atomic_store_release(&m_array, next);
+			return next;
+		}
+
+	protected:
+		/** steal end */
+		volatile int64_t m_top = { 0 };
+		char	m_pad[64];
+		/** owner end */
+		volatile int64_t m_bottom = { 0 };
+		/** current array */
+		Array* volatile m_array = { NULL };
+		/** array replaced, free when destroy */
+		std::vector<Array*> m_retire;
+	};
+}
+
+#if COMMON_SPACE
+	using common::StealDeque;
+#endif
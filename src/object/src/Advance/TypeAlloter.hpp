@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include "Advance/MemAccount.hpp"
 #include "Advance/WrapAlloter.hpp"
 
 namespace common
@@ -16,9 +17,15 @@ namespace common
 	public:
 		/** 
 		 * @brief base construct, use sys-alloc or other alloter
+		 * @param lock lock mode, wrap::WL_free for lock free with thread cache
+		 * @param type memory account type, used when alloc by itself
 		 */
-		TypeAlloter(int64_t limit = c_length_1K, bool lock = true, BaseAlloter* alloter = NULL)
-			: WrapAlloter(alloter ? alloter : this, limit, lock) { BaseAlloter::set(sizeof(Type), c_length_align); }
+		TypeAlloter(int64_t limit = c_length_1K, int lock = wrap::WL_mutex, BaseAlloter* alloter = NULL,
+				int type = account::AT_none)
+			: WrapAlloter(alloter ? alloter : this, limit, lock) {
+			BaseAlloter::set(sizeof(Type), c_length_align);
+			account(type);
+		}
 
 		/**
 		 * must set clear here, for no inherit called here
@@ -0,0 +1,219 @@
+
+#define LOG_CODE 0
+
+#include <memory>
+
+#include "Common/LogHelper.hpp"
+#include "Common/CodeHelper.hpp"
+#include "Advance/WrapAlloter.hpp"
+#include "Advance/CacheSlot.hpp"
+
+namespace common {
+
+struct WrapAlloter::Cache
+{
+public:
+	/**
+	 * check if cache is empty
+	 **/
+	bool	empty() { return m_size == 0; }
+
+	/**
+	 * pop piece
+	 **/
+	void*	pop() { return m_array[--m_size]; }
+
+	/**
+	 * push piece
+	 **/
+	void	push(void* data) { m_array[m_size++] = data; }
+
+public:
+	/** attached alloter */
+	WrapAlloter* m_owner = { NULL };
+	/** current piece count */
+	uint32_t m_size = { 0 };
+	/** piece array */
+	void*	 m_array[wrap::c_cache_len];
+	/** link in alloter */
+	ListLink m_link;
+};
+
+/** cache slot, each lock free alloter take one */
+typedef CacheSlot<WrapAlloter::Cache, wrap::c_cache_pool> WrapSlot;
+
+WrapAlloter::WrapAlloter(BaseAlloter* alloter, int limit, int lock)
+	: m_alloter(alloter), m_limit(limit), m_lock(lock), m_cache(OFFSET(Cache, m_link))
+{
+	if (m_lock == wrap::WL_free) {
+		m_slot = WrapSlot::instance().alloc();
+		if (m_slot < 0) {
+			log_info("wrap alloter cache slot exhausted, use mutex mode");
+			m_lock = wrap::WL_mutex;
+		}
+	}
+}
+
+WrapAlloter::~WrapAlloter()
+{
+	if (m_slot >= 0) {
+		Mutex::Locker lock(WrapSlot::instance().mutex());
+		Cache* cache = NULL;
+		while ((cache = (Cache*)m_cache.deque())) {
+			while (!cache->empty()) {
+				cycle(cache->pop());
+			}
+			cache->m_owner = NULL;
+		}
+		WrapSlot::instance().free(m_slot);
+		m_slot = -1;
+	}
+	clear();
+}
+
+WrapAlloter::Cache*
+WrapAlloter::cache()
+{
+	Cache*& cache = WrapSlot::local(m_slot);
+	if (!cache) {
+		cache = new Cache;
+	}
+
+	/** first time used in thread, or slot reused by new alloter */
+	if (cache->m_owner != this) {
+		Mutex::Locker lock(WrapSlot::instance().mutex());
+		cache->m_owner = this;
+		cache->m_size = 0;
+		m_cache.enque(cache);
+	}
+	return cache;
+}
+
+void*
+WrapAlloter::cache_new(size_t len)
+{
+	Cache* cache = this->cache();
+	if (cache->empty()) {
+		cache->m_size = m_stack.pop(cache->m_array, wrap::c_cache_len / 2);
+		if (cache->empty()) {
+			return malloc(len);
+		}
+	}
+	return cache->pop();
+}
+
+void
+WrapAlloter::cache_del(void* data, size_t len)
+{
+	Cache* cache = this->cache();
+	if (cache->m_size >= wrap::c_cache_len) {
+		flush(cache, wrap::c_cache_len / 2);
+	}
+	cache->push(data);
+}
+
+void
+WrapAlloter::flush(Cache* cache, uint32_t count)
+{
+	count = std::min(count, cache->m_size);
+	if (count == 0) {
+		return;
+	}
+	/** stack exceed limit, give back to origin alloter; piece may still read by pop, keep in stack if not quiet */
+	if (m_stack.size() >= (int64_t)m_limit && m_stack.quiet()) {
+		while (count-- > 0) {
+			cycle(cache->pop());
+		}
+		return;
+	}
+
+	void* last = cache->pop();
+	void* first = last;
+	for (uint32_t i = 1; i < count; i++) {
+		void* data = cache->pop();
+		FreeStack::next(data) = first;
+		first = data;
+	}
+	m_stack.push(first, last, count);
+}
+
+void
+WrapAlloter::detach(Cache* cache)
+{
+	flush(cache, cache->m_size);
+	m_cache.del(cache);
+	cache->m_owner = NULL;
+}
+}
+
+#if COMMON_TEST
+#include <cstring>
+
+#include "Common/Display.hpp"
+#include "Advance/TypeAlloter.hpp"
+#include "Perform/Debug.hpp"
+#include "Perform/Timer.hpp"
+
+namespace common {
+namespace tester {
+
+	struct WrapType
+	{
+		WrapType() { memset(data, 0, sizeof(data)); }
+		int64_t	data[4];
+	};
+
+	void
+	__type_alloter_work(TypeAlloter<WrapType>* alloter, int64_t count, int hold, bool check)
+	{
+		WrapType* array[c_length_1K];
+		assert(hold <= c_length_1K);
+		int64_t id = (int64_t)thread_info()->m_index;
+
+		for (int64_t i = 0; i < count; i++) {
+			for (int j = 0; j < hold; j++) {
+				array[j] = alloter->get();
+				if (check) {
+					success(array[j]->data[0] == 0);
+					array[j]->data[0] = id;
+					array[j]->data[3] = i;
+				}
+			}
+			for (int j = 0; j < hold; j++) {
+				if (check) {
+					success(array[j]->data[0] == id && array[j]->data[3] == i);
+				}
+				alloter->put(array[j]);
+			}
+		}
+	}
+
+	void
+	type_alloter_test()
+	{
+		do {
+			/** hold more than thread cache, piece go through stack */
+			TypeAlloter<WrapType> alloter(4096, wrap::WL_free);
+			batchs(16, __type_alloter_work, &alloter, 5000, wrap::c_cache_len * 3, true);
+			thread_wait();
+		} while (0);
+
+		const int64_t count = 50000;
+		for (int thread = 1; thread <= 16; thread *= 2) {
+			for (int mode : { wrap::WL_mutex, wrap::WL_free }) {
+				TypeAlloter<WrapType> alloter(4096, mode);
+
+				CREATE_TIMER;
+				batchs(thread, __type_alloter_work, &alloter, count, 16, false);
+				thread_wait();
+
+				ctime_t time = timer.check();
+				log_info("type alloter " << (mode == wrap::WL_free ? "lock free" : "mutex    ") << ", thread " << thread
+					<< ", ops " << string_iops(thread * count * 16 * 2, time)
+					<< ", using " << string_timer(time));
+			}
+		}
+	}
+}
+}
+#endif
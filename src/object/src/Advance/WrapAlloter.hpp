@@ -5,26 +5,44 @@
 #include "Common/Mutex.hpp"
 #include "Common/Define.hpp"
 #include "Common/TypeQueue.hpp"
+#include "Advance/List.hpp"
+#include "Advance/FreeStack.hpp"
 #include "Advance/BaseAlloter.hpp"
 
 namespace common
 {
-	/** 
+	namespace wrap {
+		/**
+		 * wrapper lock mode
+		 **/
+		enum LockMode {
+			/** no lock, single thread */
+			WL_none = 0,
+			/** mutex and deque */
+			WL_mutex,
+			/** lock free stack, with thread cache */
+			WL_free,
+		};
+		/** thread cache piece count */
+		static const int c_cache_len = 32;
+		/** max alloter count using lock free mode */
+		static const int c_cache_pool = 64;
+	}
+
+	/**
 	 * @brief wrapper alloc interface
 	 * @note work as alloter wrapper for lock and queue
 	 */
 	class WrapAlloter : public BaseAlloter
 	{
 	public:
-		/** 
+		/**
 		 * @brief base construct, use sys-alloc or other alloter
+		 * @param lock lock mode, true for mutex
 		 */
-		WrapAlloter(BaseAlloter* alloter, int limit = c_length_1K, bool lock = false)
-			: m_alloter(alloter), m_limit(limit), m_lock(lock) {}
+		WrapAlloter(BaseAlloter* alloter, int limit = c_length_1K, int lock = wrap::WL_none);
 
-		virtual ~WrapAlloter() {
-			clear();
-		}
+		virtual ~WrapAlloter();
 
 	public:
 		/**
@@ -35,7 +53,7 @@ namespace common
 		/**
 		 * get current size
 		 **/
-		int			size() { return m_list.size(); }
+		int			size() { return lockfree() ? (int)m_stack.size() : m_list.size(); }
 
 		/**
 		 * clear inner
@@ -45,14 +63,22 @@ namespace common
 				cycle(data);
 			}
 			m_list.clear();
+
+			void* data = NULL;
+			while ((data = m_stack.pop())) {
+				cycle(data);
+			}
 		}
 
 	public:
-		/** 
+		/**
 		 * @brief new for request len
 		 * @param len mem len
 		 */
 		virtual void* _new(size_t len = 0) {
+			if (lockfree()) {
+				return cache_new(len);
+			}
 			Mutex::Locker lock(m_mutex, Locking());
 			void* data = m_list.deque();
 			if (!data) {
@@ -61,13 +87,15 @@ namespace common
             return data;
 		}
 
-		/** 
+		/**
 		 * @brief del unused
 		 * @param buffer del buffer address
 		 * @param len del len, unused most times
 		 */
 		virtual void  _del(void* data, size_t len = 0) {
-
+			if (lockfree()) {
+				return cache_del(data, len);
+			}
 			Mutex::Locker lock(m_mutex, Locking());
 			if (m_list.size() < m_limit) {
 				m_list.enque(data);
@@ -76,11 +104,18 @@ namespace common
 			}
 		}
 
+		struct Cache;
+
 	protected:
 		/**
 		 * need lock or note
 		 **/
-		bool 	Locking() { return m_lock; }
+		bool 	Locking() { return m_lock == wrap::WL_mutex; }
+
+		/**
+		 * work in lock free mode
+		 **/
+		bool	lockfree() { return m_slot >= 0; }
 
 		/**
 		 * malloc new piece
@@ -106,6 +141,34 @@ namespace common
 			}
 		}
 
+	protected:
+		/**
+		 * get thread cache, attach if not yet
+		 **/
+		Cache*	cache();
+
+		/**
+		 * alloc from thread cache, refill from stack if empty
+		 **/
+		void*	cache_new(size_t len = 0);
+
+		/**
+		 * put to thread cache, flush half to stack if full
+		 **/
+		void	cache_del(void* data, size_t len = 0);
+
+		/**
+		 * flush cache piece to stack, cycle if exceed limit
+		 **/
+		void	flush(Cache* cache, uint32_t count);
+
+		/**
+		 * detach cache from alloter, return all piece
+		 **/
+		void	detach(Cache* cache);
+
+		template<class, int> friend class CacheSlot;
+
 	protected:
 		/** object mutex */
 		Mutex 	m_mutex = { "type alloter" };
@@ -113,14 +176,19 @@ namespace common
 		BaseAlloter* m_alloter = {NULL};
 		/** total limit */
 		size_t	m_limit = {0};
-		/** use lock or note */
-		bool  	m_lock 	= {false};
+		/** lock mode */
+		int  	m_lock 	= {wrap::WL_none};
 		/** temparary list */
 		TypeQueue<void*> m_list;
+		/** lock free stack */
+		FreeStack m_stack;
+		/** thread cache list */
+		List	m_cache;
+		/** thread cache slot, -1 if not lock free */
+		int		m_slot = { -1 };
 	};
 }
 
 #if COMMON_SPACE
 	using common::WrapAlloter;
 #endif
-
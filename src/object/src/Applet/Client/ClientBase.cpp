@@ -11,7 +11,8 @@
 namespace applet {
 namespace client {
 
-static ::common::TypeAlloter<Context> s_context(4096);
+static ::common::TypeAlloter<Context> s_context(4096, ::common::wrap::WL_free,
+	NULL, ::common::account::AT_client);
 
 void
 Context::Done(int64_t key, int64_t data)
@@ -204,6 +204,11 @@ ClientManage::Notify(int index, int type)
 void
 ClientManage::ResetStatis()
 {
+	Placement place;
+	if (place.parse(mConfig->work.place) != 0) {
+		log_warn("statistic thread placement " << mConfig->work.place << " invalid, ignore");
+	}
+	g_statis_thread.placement(place);
 	g_statis_thread.start();
 	g_statis_thread.restart();
 }
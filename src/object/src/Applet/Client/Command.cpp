@@ -314,7 +314,8 @@ Command::default_options()
 		("clear", 		PO_BOOL(config.work.clear), "clear all data")
 		("type", 		PO_TYPE(config.work.type), "message type")
 		("server", 		PO_BOOL(config.work.server), "run as daemon server")
-		("interval,i", 	PO_TYPE(config.work.interval), "output interval\n")
+		("interval,i", 	PO_TYPE(config.work.interval), "output interval")
+		("place", 		PO_TYPE(config.work.place), "statistic thread placement, none, list:0-3, spread or compact:node\n")
 
 	//m_load.add_options()
 		("thread", 		PO_TYPE(config.load.thread), "thread count")
@@ -105,6 +105,8 @@ namespace client {
 			int		wait	= {30000};
 			/** output interval */
 			int		interval = {0};
+			/** statistic thread placement, none, list:0-3, spread or compact:node */
+			std::string place = {"none"};
 		} work;
 
 		/**
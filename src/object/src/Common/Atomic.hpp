@@ -1,6 +1,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 namespace common {
 
 	/**
@@ -93,6 +95,7 @@ namespace common {
 	/**
 	 * @note if success, return the old mem value, equal cmp
 	 * @note if failed, return the value of mem
+	 * @note full barrier, memory access not moved across it
 	 **/
 	static inline int
 	atomic_comp_swap(volatile void *mem, int xchg, int cmp) {
@@ -100,6 +103,7 @@ namespace common {
 				"lock cmpxchg %1, (%2)"
 				:"=a"(cmp)
 				:"d"(xchg), "r"(mem), "a"(cmp)
+				: "memory"
 		);
 		return cmp;
 	}
@@ -110,6 +114,7 @@ namespace common {
 				"lock cmpxchg %1, (%2)"
 				:"=a"(cmp)
 				:"d"(xchg), "r"(mem), "a"(cmp)
+				: "memory"
 		);
 		return cmp;
 	}
@@ -139,6 +144,32 @@ namespace common {
 		int 	refer = {1};
 	};
 
+	/**
+	 * store with release order, memory access before it visible first
+	 **/
+	template<class T, class V>
+	static inline void
+	atomic_store_release(volatile T* mem, V value) {
+		__atomic_store_n(mem, (T)value, __ATOMIC_RELEASE);
+	}
+
+	/**
+	 * load with acquire order, memory access after it not moved before
+	 **/
+	template<class T>
+	static inline T
+	atomic_load_acquire(volatile T* mem) {
+		return __atomic_load_n(mem, __ATOMIC_ACQUIRE);
+	}
+
+	/**
+	 * full fence, store before it visible before load after it
+	 **/
+	static inline void
+	atomic_fence() {
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	}
+
 	/** fast macro */
 	#define at_inc(x) 	common::atomic_add(&x, 1)
 	#define at_dec(x) 	common::atomic_add(&x, -1)
@@ -3,6 +3,7 @@
 
 #include <map>
 #include <set>
+#include <memory>
 
 namespace common {
 
@@ -20,11 +21,12 @@ namespace common {
 	/**
 	 * @brief type set
 	 */
-	template<class Type, class Comp = std::less<Type> >
+	template<class Type, class Comp = std::less<Type>, class Alloc = std::allocator<Type> >
 	class TypeSet
 	{
 	public:
 		TypeSet() {}
+		TypeSet(const Alloc& alloc) : m_local(Comp(), alloc) {}
 		TypeSet(std::initializer_list<Type> array) {
 			for (const auto &type : array) {
 				success(add(type));
@@ -33,7 +35,7 @@ namespace common {
 		virtual ~TypeSet() {}
 
 	public:
-		typedef typename std::set<Type, Comp> curr_type;
+		typedef typename std::set<Type, Comp, Alloc> curr_type;
 		typedef typename curr_type::iterator  curr_iter;
 
 		/**
@@ -169,7 +171,8 @@ namespace common {
 	/**
 	 * type map
 	 **/
-	template<class Key, class Type,	class Comp = std::less<Key> >
+	template<class Key, class Type,	class Comp = std::less<Key>,
+		class Alloc = std::allocator<std::pair<const Key, Type> > >
 	class TypeMap
 	{
 	public:
@@ -177,6 +180,8 @@ namespace common {
 
 		TypeMap(Type type) : m_type(type) {}
 
+		TypeMap(const Alloc& alloc, Type type = Type()) : m_type(type), m_local(Comp(), alloc) {}
+
 		struct Pair {
 			Key	 key;
 			Type type;
@@ -188,7 +193,7 @@ namespace common {
 			}
 		}
 	public:
-		typedef typename std::map<Key,Type, Comp> curr_type;
+		typedef typename std::map<Key,Type, Comp, Alloc> curr_type;
 		typedef typename curr_type::iterator	curr_iter;
 		typedef typename curr_type::value_type 	curr_value;
 
@@ -13,6 +13,8 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <limits.h>
 #include <cstring>
 
 #include "Common/Util.hpp"
@@ -298,6 +300,65 @@ file_read(file_handle_t fd, char* data, uint32_t len, uint64_t off)
 	return read(fd, data, len);
 }
 
+/**
+ * skip done length, iovec point to the first one not done
+ **/
+static void
+iov_skip(struct iovec*& iov, int& count, size_t done)
+{
+	while (count > 0 && done >= iov->iov_len) {
+		done -= iov->iov_len;
+		iov++;
+		count--;
+	}
+	if (count > 0) {
+		iov->iov_base = (char*)iov->iov_base + done;
+		iov->iov_len -= done;
+	}
+}
+
+/**
+ * vectored io until all done, file end or failed
+ **/
+static int64_t
+file_vector(file_handle_t fd, struct iovec* iov, int count, uint64_t off, bool write)
+{
+	int64_t total = 0;
+	while (count > 0) {
+		int batch = std::min(count, IOV_MAX);
+		ssize_t ret = 0;
+		if (off == c_invalid_offset) {
+			ret = write ? ::writev(fd, iov, batch) : ::readv(fd, iov, batch);
+		} else {
+			ret = write ? ::pwritev(fd, iov, batch, off + total) : ::preadv(fd, iov, batch, off + total);
+		}
+		if (ret < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return -1;
+		}
+		total += ret;
+		iov_skip(iov, count, ret);
+		if (ret == 0) {
+			break;
+		}
+	}
+	return total;
+}
+
+int64_t
+file_writev(file_handle_t fd, struct iovec* iov, int count, uint64_t off)
+{
+	return file_vector(fd, iov, count, off, true);
+}
+
+int64_t
+file_readv(file_handle_t fd, struct iovec* iov, int count, uint64_t off)
+{
+	return file_vector(fd, iov, count, off, false);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -535,6 +596,33 @@ FileBase::pread(void* buf, uint32_t len, uint64_t off)
 	}
 }
 
+int64_t
+FileBase::writev(struct iovec* iov, int count)
+{
+	if (!is_open()) {
+		return -1;
+	}
+	return file_writev(m_fd, iov, count);
+}
+
+int64_t
+FileBase::pwritev(struct iovec* iov, int count, uint64_t off)
+{
+	if (!is_open()) {
+		return -1;
+	}
+	return file_writev(m_fd, iov, count, off);
+}
+
+int64_t
+FileBase::preadv(struct iovec* iov, int count, uint64_t off)
+{
+	if (!is_open()) {
+		return -1;
+	}
+	return file_readv(m_fd, iov, count, off);
+}
+
 int
 FileBase::trunc(uint64_t len)
 {
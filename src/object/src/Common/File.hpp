@@ -6,6 +6,8 @@
 
 #include "Common/Const.hpp"
 
+struct iovec;
+
 namespace common {
 
 	typedef int file_handle_t;
@@ -187,6 +189,26 @@ namespace common {
 	 */
 	int			file_write(file_handle_t fd, const char* buffer, uint32_t len, uint64_t off = c_invalid_offset);
 
+	/**
+	 * @brief write iovec to file, continue when partial written
+	 * @param fd file handle
+	 * @param iov iovec array, changed when partial written
+	 * @param count iovec count, split by IOV_MAX
+	 * @param off write off, if default, write at current pos
+	 * @return written len, -1 if failed
+	 */
+	int64_t		file_writev(file_handle_t fd, struct ::iovec* iov, int count, uint64_t off = c_invalid_offset);
+
+	/**
+	 * @brief read file to iovec, continue until full or file end
+	 * @param fd file handle
+	 * @param iov iovec array, changed when partial read
+	 * @param count iovec count, split by IOV_MAX
+	 * @param off read off, if default, read at current pos
+	 * @return read len, -1 if failed
+	 */
+	int64_t		file_readv(file_handle_t fd, struct ::iovec* iov, int count, uint64_t off = c_invalid_offset);
+
 	#ifndef _WIN32
 	uint32_t		file_write_all(int fd, char* buffer, uint32_t len);
 	uint32_t		file_read_all(int fd, char* buffer, uint32_t len);
@@ -407,6 +429,32 @@ namespace common {
 		 */
 		int			pread(void* buf, uint32_t len, uint64_t off);
 
+		/**
+		 * @brief write iovec at current off, in one syscall if possible
+		 * @param iov iovec array, changed when partial written
+		 * @param count iovec count
+		 * @return written len, -1 if failed
+		 */
+		int64_t		writev(struct ::iovec* iov, int count);
+
+		/**
+		 * @brief write iovec at off
+		 * @param iov iovec array, changed when partial written
+		 * @param count iovec count
+		 * @param off write off
+		 * @return written len, -1 if failed
+		 */
+		int64_t		pwritev(struct ::iovec* iov, int count, uint64_t off);
+
+		/**
+		 * @brief read to iovec at off
+		 * @param iov iovec array, changed when partial read
+		 * @param count iovec count
+		 * @param off read off
+		 * @return read len, -1 if failed
+		 */
+		int64_t		preadv(struct ::iovec* iov, int count, uint64_t off);
+
 		/**
 		 * @brief flush all right now
 		 */
@@ -0,0 +1,476 @@
+
+#pragma once
+
+#include <cerrno>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+#include "Common/Atomic.hpp"
+#include "Common/Mutex.hpp"
+#include "Common/Cond.hpp"
+#include "Common/ThreadPool.hpp"
+
+namespace common
+{
+	/**
+	 * shared state of future, refer by future and the one complete it
+	 *
+	 * @note continuation run in thread complete the state, or in caller
+	 * 		 at once if already done, no thread parked for it
+	 */
+	class FutureState
+	{
+	public:
+		FutureState() {}
+		virtual ~FutureState() {}
+
+		FutureState(const FutureState&) = delete;
+		FutureState& operator = (const FutureState&) = delete;
+
+	public:
+		/**
+		 * increase refer
+		 **/
+		void	inc() { m_refer.inc(); }
+
+		/**
+		 * decrease refer, delete if last one
+		 **/
+		void	dec() {
+			if (m_refer.dec()) {
+				delete this;
+			}
+		}
+
+		/**
+		 * check if done
+		 **/
+		bool	done() { return m_done; }
+
+		/**
+		 * get error, valid after done
+		 **/
+		int		error() { return m_error; }
+
+		/**
+		 * wait until done
+		 **/
+		void	wait() {
+			Mutex::Locker lock(m_mutex);
+			while (!m_done) {
+				m_cond.wait(m_mutex);
+			}
+		}
+
+		/**
+		 * add continuation, run at once if already done
+		 **/
+		void	follow(std::function<void()>&& func) {
+			do {
+				Mutex::Locker lock(m_mutex);
+				if (!m_done) {
+					m_follow.push_back(std::move(func));
+					return;
+				}
+			} while (0);
+			func();
+		}
+
+		/**
+		 * set done and wakeup waiter, then run continuation in current thread
+		 **/
+		void	finish(int error = 0) {
+			std::vector<std::function<void()>> follow;
+			do {
+				Mutex::Locker lock(m_mutex);
+				assert(!m_done);
+				m_error = error;
+				m_done = true;
+				follow.swap(m_follow);
+				m_cond.signal_all();
+			} while (0);
+
+			for (auto& func : follow) {
+				func();
+			}
+		}
+
+	protected:
+		/** reference */
+		Refer	m_refer;
+		/** protect state and continuation */
+		Mutex	m_mutex = {"future"};
+		/** wakeup waiter */
+		Cond	m_cond;
+		/** value set and continuation taken */
+		volatile bool m_done = {false};
+		/** error, ECANCELED if task cancelled */
+		int		m_error = {0};
+		/** continuation waiting done */
+		std::vector<std::function<void()>> m_follow;
+	};
+
+	/**
+	 * state with value
+	 **/
+	template<class T>
+	class FutureValue : public FutureState
+	{
+	public:
+		/** result, default if error */
+		T		m_value = T();
+	};
+
+	template<>
+	class FutureValue<void> : public FutureState
+	{
+	};
+
+	/**
+	 * call helper, hide void difference
+	 **/
+	template<class T>
+	struct FutureCall
+	{
+		/** result of continuation */
+		template<class F>
+		using result_t = typename std::result_of<F&(T&)>::type;
+
+		/**
+		 * run func with args, keep result in state
+		 **/
+		template<class F, class...A>
+		static void set(FutureValue<T>* state, F& func, A&...args) {
+			state->m_value = func(args...);
+		}
+
+		/**
+		 * run continuation with value of prev, keep result in next
+		 **/
+		template<class R, class F>
+		static void then(FutureValue<T>* prev, F& func, FutureValue<R>* next) {
+			FutureCall<R>::set(next, func, prev->m_value);
+		}
+
+		/**
+		 * get value
+		 **/
+		static T value(FutureValue<T>* state) { return state->m_value; }
+	};
+
+	template<>
+	struct FutureCall<void>
+	{
+		template<class F>
+		using result_t = typename std::result_of<F&()>::type;
+
+		template<class F, class...A>
+		static void set(FutureValue<void>* state, F& func, A&...args) {
+			func(args...);
+		}
+
+		template<class R, class F>
+		static void then(FutureValue<void>* prev, F& func, FutureValue<R>* next) {
+			FutureCall<R>::set(next, func);
+		}
+
+		static void value(FutureValue<void>* state) {}
+	};
+
+	/**
+	 * pool task run callable, release itself
+	 **/
+	template<class F>
+	class FutureTask : public ThreadPool::Task
+	{
+	public:
+		FutureTask(F func)
+			: m_func(std::move(func)) { m_alone = true; }
+
+	public:
+		/**
+		 * run with no error
+		 **/
+		virtual bool operator ()() {
+			m_func(0);
+			return true;
+		}
+
+	protected:
+		/**
+		 * func called with error if cancelled, before work
+		 **/
+		virtual void release(int eno) {
+			if (eno != 0) {
+				m_func(eno);
+			}
+			delete this;
+		}
+
+	protected:
+		/** called with error, 0 for run */
+		F		m_func;
+	};
+
+	/**
+	 * make pool task of func
+	 **/
+	template<class F>
+	ThreadPool::Task* future_task(F&& func) {
+		return new FutureTask<typename std::decay<F>::type>(std::forward<F>(func));
+	}
+
+	/**
+	 * @brief result of async work, copy share the same state
+	 *
+	 * @note then without pool run continuation inline, in thread complete
+	 * 		 this one, or at once if already done; then with pool add
+	 * 		 continuation to pool when done
+	 * @note continuation skipped if error, error pass to the next
+	 * @note callable should not throw, report error by result
+	 */
+	template<class T>
+	class Future
+	{
+	public:
+		Future() {}
+
+		/**
+		 * take one refer of state
+		 **/
+		explicit Future(FutureValue<T>* state)
+			: m_state(state) {}
+
+		Future(const Future& other)
+			: m_state(other.m_state) {
+			if (m_state) {
+				m_state->inc();
+			}
+		}
+
+		Future(Future&& other)
+			: m_state(other.m_state) {
+			other.m_state = NULL;
+		}
+
+		Future& operator = (Future other) {
+			std::swap(m_state, other.m_state);
+			return *this;
+		}
+
+		~Future() {
+			if (m_state) {
+				m_state->dec();
+			}
+		}
+
+	public:
+		/**
+		 * check if have state
+		 **/
+		bool	valid() const { return m_state != NULL; }
+
+		/**
+		 * check if done
+		 **/
+		bool	done() const { return m_state->done(); }
+
+		/**
+		 * wait done
+		 * @return error
+		 **/
+		int		wait() const {
+			m_state->wait();
+			return m_state->error();
+		}
+
+		/**
+		 * get error, valid after done
+		 **/
+		int		error() const { return m_state->error(); }
+
+		/**
+		 * wait done and get value, default value if error
+		 **/
+		T		get() const {
+			m_state->wait();
+			return FutureCall<T>::value(m_state);
+		}
+
+		/**
+		 * get shared state
+		 **/
+		FutureValue<T>* state() const { return m_state; }
+
+	public:
+		/**
+		 * run func with value when done, inline
+		 **/
+		template<class F, class R = typename FutureCall<T>::template result_t<F>>
+		Future<R> then(F&& func) const {
+			FutureValue<T>* prev = m_state;
+			FutureValue<R>* next = new FutureValue<R>();
+			/** one for continuation */
+			next->inc();
+			prev->follow([prev, next, func = std::forward<F>(func)]() mutable {
+				int error = prev->error();
+				if (error == 0) {
+					FutureCall<T>::then(prev, func, next);
+				}
+				next->finish(error);
+				next->dec();
+			});
+			return Future<R>(next);
+		}
+
+		/**
+		 * add func with value to pool when done
+		 **/
+		template<class F, class R = typename FutureCall<T>::template result_t<F>>
+		Future<R> then(ThreadPool& pool, F&& func) const {
+			FutureValue<T>* prev = m_state;
+			FutureValue<R>* next = new FutureValue<R>();
+			next->inc();
+			/** value read in pool thread, keep prev */
+			prev->inc();
+			prev->follow([&pool, prev, next, func = std::forward<F>(func)]() mutable {
+				int error = prev->error();
+				if (error != 0) {
+					prev->dec();
+					next->finish(error);
+					next->dec();
+					return;
+				}
+				pool.add(future_task([prev, next, func = std::move(func)](int eno) mutable {
+					if (eno == 0) {
+						FutureCall<T>::then(prev, func, next);
+					}
+					prev->dec();
+					next->finish(eno);
+					next->dec();
+				}));
+			});
+			return Future<R>(next);
+		}
+
+	protected:
+		/** shared state */
+		FutureValue<T>* m_state = {NULL};
+	};
+
+	/**
+	 * future done with value
+	 **/
+	template<class T>
+	Future<typename std::decay<T>::type> make_future(T&& value) {
+		typedef typename std::decay<T>::type R;
+		FutureValue<R>* state = new FutureValue<R>();
+		state->m_value = std::forward<T>(value);
+		state->finish();
+		return Future<R>(state);
+	}
+
+	/**
+	 * future done without value
+	 **/
+	inline Future<void> make_future() {
+		FutureValue<void>* state = new FutureValue<void>();
+		state->finish();
+		return Future<void>(state);
+	}
+
+	/**
+	 * done when all done, error is the first error seen
+	 **/
+	template<class T>
+	Future<void> when_all(const std::vector<Future<T>>& list) {
+		if (list.empty()) {
+			return make_future();
+		}
+		struct Joint {
+			volatile int remain;
+			volatile int error;
+		};
+		Joint* joint = new Joint{(int)list.size(), 0};
+		FutureValue<void>* next = new FutureValue<void>();
+		next->inc();
+
+		for (auto& future : list) {
+			FutureValue<T>* prev = future.state();
+			prev->follow([prev, next, joint]() {
+				if (prev->error() != 0) {
+					atomic_comp_swap(&joint->error, prev->error(), 0);
+				}
+				if (atomic_add(&joint->remain, -1) == 1) {
+					int error = joint->error;
+					delete joint;
+					next->finish(error);
+					next->dec();
+				}
+			});
+		}
+		return Future<void>(next);
+	}
+
+	/**
+	 * done when any done, value is its index, error is its error
+	 * @note EINVAL if list empty
+	 **/
+	template<class T>
+	Future<int> when_any(const std::vector<Future<T>>& list) {
+		FutureValue<int>* next = new FutureValue<int>();
+		if (list.empty()) {
+			next->m_value = -1;
+			next->finish(EINVAL);
+			return Future<int>(next);
+		}
+		struct Joint {
+			volatile int remain;
+			volatile int first;
+		};
+		Joint* joint = new Joint{(int)list.size(), 0};
+		next->inc();
+
+		for (int index = 0; index < (int)list.size(); index++) {
+			FutureValue<T>* prev = list[index].state();
+			prev->follow([prev, next, joint, index]() {
+				if (atomic_comp_swap(&joint->first, 1, 0) == 0) {
+					next->m_value = index;
+					next->finish(prev->error());
+					next->dec();
+				}
+				if (atomic_add(&joint->remain, -1) == 1) {
+					delete joint;
+				}
+			});
+		}
+		return Future<int>(next);
+	}
+
+	template<class F>
+	auto
+	ThreadPool::submit(F&& func) -> Future<typename std::result_of<F&()>::type>
+	{
+		typedef typename std::result_of<F&()>::type R;
+		FutureValue<R>* state = new FutureValue<R>();
+		/** one for task */
+		state->inc();
+		add(future_task([state, func = std::forward<F>(func)](int eno) mutable {
+			if (eno == 0) {
+				FutureCall<R>::set(state, func);
+			}
+			state->finish(eno);
+			state->dec();
+		}));
+		return Future<R>(state);
+	}
+}
+
+#if COMMON_SPACE
+	using common::Future;
+	using common::make_future;
+	using common::when_all;
+	using common::when_any;
+#endif
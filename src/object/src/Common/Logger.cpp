@@ -21,6 +21,7 @@
 #include "Common/String.hpp"
 #include "Common/ThreadInfo.hpp"
 #include "Advance/Barrier.hpp"
+#include "Advance/MemAccount.hpp"
 
 namespace common {
 //Barrier& s_log_barrier = *Singleton<Barrier>::get();
@@ -251,7 +252,11 @@ Logging::format(LogLevel level, const char* string, bool lock)
             format(level, string, lock);
             return;
         }
+	    /** formatted message held until handler write it out */
+	    int64_t len = strlen(string) + 1;
+	    mem_account(account::AT_logger, len);
 	    int64_t writen = m_handle(m_logfd, level, &m_param, string);
+	    mem_account(account::AT_logger, -len);
 	    common::atomic_add64(&m_length, writen);
     }
 
@@ -128,6 +128,29 @@ namespace tester {
 		REGIST(10, convert_test);
 		REGIST(11, statistic_test);
 		REGIST(12, random_test);
+		REGIST(13, mem_magazine_test);
+		REGIST(14, slab_alloter_test);
+		REGIST(15, mem_page_test);
+		REGIST(16, mem_scavenge_test);
+		REGIST(17, arena_test);
+		REGIST(18, type_alloter_test);
+		REGIST(19, remote_alloter_test);
+		REGIST(20, mem_resource_test);
+		REGIST(21, mem_account_test);
+		REGIST(22, mem_governor_test);
+		REGIST(23, dyn_iovec_test);
+		REGIST(24, dyn_share_test);
+		REGIST(25, dyn_seek_test);
+		REGIST(26, cycle_buffer_test);
+		REGIST(27, concurrent_cycle_test);
+		REGIST(28, buffer_array_test);
+		REGIST(29, hash_test);
+		REGIST(30, codec_test);
+		REGIST(31, hash_bench_test);
+		REGIST(32, thread_pool_bench_test);
+		REGIST(33, topology_test);
+		REGIST(34, thread_pool_class_test);
+		REGIST(35, future_test);
 	}
 }
 }
@@ -52,6 +52,16 @@ namespace common {
 		 **/
 		void 	set_name(const char* name = "", int type = 0);
 
+		/**
+		 * set cpu bind when thread start, -1 for not bind
+		 **/
+		void	set_cpu(int cpu) { m_cpu = cpu; }
+
+		/**
+		 * get cpu bind
+		 **/
+		int		cpu() { return m_cpu; }
+
 		//static int get_num_threads() { return _num_threads.test(); }
 
 		/**
@@ -92,14 +102,22 @@ namespace common {
 		static void *_entry_func(void *arg) {
 			CommonThread* thread = (CommonThread*)arg;
 			thread->set_name();
+			thread->bind();
 			return thread->entry();
 		}
 
+		/**
+		 * bind current thread to cpu if set
+		 **/
+		void	bind();
+
 	private:
 		/** thread id */
 		pthread_t 	m_thread_id = {0};
 		char		m_name[32] = {0};
 		int			m_type = {0};
+		/** cpu bind, -1 for not bind */
+		int			m_cpu = {-1};
 	};
 }
 
@@ -6,15 +6,36 @@
 #include <unistd.h>
 #include <cstring>
 #include <signal.h>
+#include <cerrno>
+#include <linux/futex.h>
+#include <sys/syscall.h>
 
 #include "Common/Common.hpp"
 #include "Common/Atomic.hpp"
+#include "Common/Display.hpp"
 #include "Common/LogHelper.hpp"
 #include "Common/ThreadInfo.hpp"
 #include "Common/ThreadPool.hpp"
+#include "Common/Topology.hpp"
 
 namespace common {
 
+/**
+ * wait on futex while value not changed, timeout in ms, -1 for ever
+ * @return false if timeout
+ **/
+static bool
+futex_wait(volatile int* futex, int value, int timeout)
+{
+	struct timespec time;
+	if (timeout >= 0) {
+		time.tv_sec = timeout / 1000;
+		time.tv_nsec = (timeout % 1000) * 1000000L;
+	}
+	return syscall(SYS_futex, futex, FUTEX_WAIT_PRIVATE, value,
+		timeout >= 0 ? &time : NULL, NULL, 0) == 0 || errno != ETIMEDOUT;
+}
+
 void
 CommonThread::set_name(const char* name, int type)
 {
@@ -28,6 +49,20 @@ CommonThread::set_name(const char* name, int type)
 	}
 }
 
+void
+CommonThread::bind()
+{
+	if (m_cpu < 0) {
+		return;
+	}
+	/** cpu not allowed, such as cpuset limit, keep running unbind */
+	int ret = bind_cpu(m_cpu);
+	if (ret != 0) {
+		log_warn("thread " << m_name << " bind cpu " << m_cpu << ", failed " << ret);
+		m_cpu = -1;
+	}
+}
+
 int
 CommonThread::create(bool detach, thread_handle_t handle, void* arg)
 {
@@ -183,14 +218,19 @@ ThreadPool::stop(bool wait_pend)
 		}
 		m_status = ST_stop;
 		m_cond.signal_all();
+		wakeup_all();
 		debug("thread pool stop, notify all");
 	} while (0);
 
-	cancel(true);
-
+	/** join before cancel, no task pushed to local deque after clear */
 	for (auto& thread : m_threads) {
 		thread->join();
 		debug("thread pool stop, thread " << thread->index() << " join");
+	}
+	cancel(true);
+
+	/** delete after all joined, thread may be stolen by others before exit */
+	for (auto& thread : m_threads) {
 		delete thread;
 	}
 	m_threads.clear();
@@ -210,7 +250,7 @@ ThreadPool::pause(bool wait_curr)
 			return -1;
 		}
 		m_status = ST_pause;
-		debug("thread pool pause, cancel pending task " << m_prior.size() + m_tasks.size()
+		debug("thread pool pause, cancel pending task " << pending()
 			<< ", will deny new ones");
 	} while (0);
 
@@ -219,22 +259,63 @@ ThreadPool::pause(bool wait_curr)
 }
 
 int
-ThreadPool::add(Task* task, bool front)
+ThreadPool::add_batch(Task** tasks, int count, bool front)
 {
+	if (count <= 0) {
+		return 0;
+	}
+	/** add by worker, push local deque without lock; class or deadline need shared */
+	Thread* thread = NULL;
+	if (m_mode == SM_steal && front && !m_classed && (thread = local()) && thread->pool() == this) {
+		if (!working()) {
+			for (int i = 0; i < count; i++) {
+				cycle_task(tasks[i], ECANCELED);
+			}
+			trace("add task, cancel " << count << ", thread pool already " << (status() == ST_pause ? "pause" : "stop"));
+			return -1;
+		}
+		atomic_add64(&m_curr, count);
+		/** local pop lifo, push reverse */
+		for (int i = count - 1; i >= 0; i--) {
+			thread->m_deque.push(tasks[i]);
+		}
+		/** deque store visible before check idle, pair with steal_wait */
+		atomic_fence();
+		if (atomic_load_acquire(&m_idle) > 0 && atomic_load_acquire(&m_waking) == 0) {
+			wakeup_one();
+		}
+		return 0;
+	}
+
 	Mutex::Locker lock(m_mutex);
 	if (!working()) {
-		cycle_task(task, ECANCELED);
-		trace("add task, cancel it, thread pool already " << (status() == ST_pause ? "pause" : "stop"));
+		for (int i = 0; i < count; i++) {
+			cycle_task(tasks[i], ECANCELED);
+		}
+		trace("add task, cancel " << count << ", thread pool already " << (status() == ST_pause ? "pause" : "stop"));
 		return -1;
 	}
 
-	if (front) {
-		m_tasks.push_front(task);
+	/** class not set, plain fifo, task not touched */
+	if (!m_classed) {
+		task_deque_t& list = m_class[0].tasks;
+		list.insert(front ? list.begin() : list.end(), tasks, tasks + count);
+
+	} else {
+		ctime_t now = ctime_now();
+		/** class fifo, oldest at front for starve check */
+		for (int i = 0; i < count; i++) {
+			class_push(tasks[i], now);
+		}
+	}
+	m_shared += count;
+	atomic_add64(&m_curr, count);
+	/** one wakeup, worker wakeup next if task remain */
+	if (m_mode == SM_steal) {
+		wakeup_one();
 	} else {
-		m_tasks.push_back(task);
+		m_cond.signal_one();
 	}
-	atomic_inc64(&m_curr);
-	m_cond.signal_one();
 
 	//task->m_time = ctime_now();
 	return 0;
@@ -243,6 +324,139 @@ ThreadPool::add(Task* task, bool front)
 /**
  * put task back to queue
  **/
+void
+ThreadPool::class_push(Task* task, ctime_t now)
+{
+	int index = std::min(std::max(task->priority(), 0), (int)m_class.size() - 1);
+	TaskClass& klass = m_class[index];
+	/** class idle before, not keep credit of idle time */
+	if (klass.size() == 0) {
+		klass.pass = std::max(klass.pass, m_pass);
+	}
+	task->m_queued = now;
+
+	if (task->deadline() != 0) {
+		klass.timed.insert(task);
+		klass.aged.insert(task);
+	} else {
+		klass.tasks.push_back(task);
+	}
+}
+
+ThreadPool::Task*
+ThreadPool::class_task(ctime_t now)
+{
+	/** class not set, plain fifo */
+	if (!m_classed) {
+		TaskClass& only = m_class[0];
+		if (only.tasks.empty()) {
+			return NULL;
+		}
+		Task* task = only.tasks.front();
+		only.tasks.pop_front();
+		only.count++;
+		m_shared--;
+		return task;
+	}
+	TaskClass* klass = NULL;
+	bool starve = false;
+
+	/** task waited over limit first, the longest one */
+	if (m_starve > 0) {
+		ctime_t oldest = now - m_starve;
+		for (auto& curr : m_class) {
+			if (!curr.tasks.empty() && curr.tasks.front()->queued() < oldest) {
+				oldest = curr.tasks.front()->queued();
+				klass = &curr;
+				starve = true;
+			}
+			if (!curr.aged.empty() && (*curr.aged.begin())->queued() < oldest) {
+				oldest = (*curr.aged.begin())->queued();
+				klass = &curr;
+				starve = true;
+			}
+		}
+	}
+	/** least pass first */
+	if (!klass) {
+		for (auto& curr : m_class) {
+			if (curr.size() > 0 && (!klass || curr.pass < klass->pass)) {
+				klass = &curr;
+			}
+		}
+	}
+	if (!klass) {
+		return NULL;
+	}
+	m_pass = klass->pass;
+	klass->pass += klass->stride;
+
+	/** deadline first, or the longest waited one if starve */
+	Task* task = NULL;
+	if (!klass->timed.empty() && starve) {
+		task = *klass->aged.begin();
+		if (!klass->tasks.empty() && klass->tasks.front()->queued() < task->queued()) {
+			task = NULL;
+		}
+	} else if (!klass->timed.empty()) {
+		task = *klass->timed.begin();
+	}
+	if (task) {
+		klass->timed.erase(task);
+		klass->aged.erase(task);
+	} else {
+		task = klass->tasks.front();
+		klass->tasks.pop_front();
+	}
+	m_shared--;
+
+	int64_t wait = now > task->queued() ? now - task->queued() : 0;
+	klass->count++;
+	klass->wait += wait;
+	klass->most = std::max(klass->most, wait);
+	if (task->deadline() != 0 && now > task->deadline()) {
+		klass->miss++;
+	}
+	return task;
+}
+
+int
+ThreadPool::classes(const std::vector<int>& weight, int starve)
+{
+	Mutex::Locker lock(m_mutex);
+	if (running() || weight.empty()) {
+		return -1;
+	}
+	m_class.clear();
+	m_class.resize(weight.size());
+	for (size_t i = 0; i < weight.size(); i++) {
+		m_class[i].stride = c_stride / std::max(weight[i], 1);
+	}
+	m_starve = (ctime_t)starve * c_time_level[0];
+	m_pass = 0;
+	m_classed = true;
+	return 0;
+}
+
+std::string
+ThreadPool::dump_class(bool reset)
+{
+	Mutex::Locker lock(m_mutex);
+	std::string str;
+	for (size_t i = 0; i < m_class.size(); i++) {
+		TaskClass& klass = m_class[i];
+		str += (i > 0 ? ", " : "") + std::to_string(i) + ": pend " + std::to_string(klass.size())
+			+ " done " + std::to_string(klass.count)
+			+ " wait " + string_timer(klass.count ? klass.wait / klass.count : 0)
+			+ " max " + string_timer(klass.most)
+			+ " miss " + std::to_string(klass.miss);
+		if (reset) {
+			klass.count = klass.wait = klass.most = klass.miss = 0;
+		}
+	}
+	return str;
+}
+
 int
 ThreadPool::add_prior(Task* task, bool front)
 {
@@ -258,8 +472,13 @@ ThreadPool::add_prior(Task* task, bool front)
 	} else {
 		m_prior.push_back(task);
 	}
+	m_shared++;
 	atomic_inc64(&m_curr);
-	m_cond.signal_one();
+	if (m_mode == SM_steal) {
+		wakeup_one();
+	} else {
+		m_cond.signal_one();
+	}
 	return 0;
 }
 
@@ -276,6 +495,21 @@ ThreadPool::set_name(const char* name)
 	}
 }
 
+std::string
+ThreadPool::dump_place()
+{
+	Mutex::Locker lock(m_mutex);
+	std::string str = m_place.dump() + ",";
+	for (auto thread : m_threads) {
+		/** bind failed or not set, cpu is -1 */
+		int cpu = thread->cpu();
+		str += " " + std::to_string(thread->index());
+		str += cpu < 0 ? "@any" : "@cpu" + std::to_string(cpu)
+			+ "/node" + std::to_string(topology().node(cpu));
+	}
+	return str;
+}
+
 void
 ThreadPool::insert_thread(Thread* thread)
 {
@@ -286,6 +520,10 @@ ThreadPool::insert_thread(Thread* thread)
 bool
 ThreadPool::next(Thread* thread)
 {
+	if (m_mode == SM_steal) {
+		return next_steal(thread);
+	}
+
 	#if TIME_RECORD
 		thread->m_times.reset(true, 5000);
 		thread->m_times.next("wait last");
@@ -304,20 +542,30 @@ ThreadPool::next(Thread* thread)
 			debug("next task, thread " << thread->index() << " wakeup but already stop, exit");
 			return false;
 
-		} else if (!(task = next_task())) {
+		}
+		/** one clock for all fetched */
+		ctime_t now = m_classed ? ctime_now() : 0;
+		if (!(task = next_task(now))) {
 			debug("next task, thread " << thread->index() << " wakeup but no task");
 			return true;
 		}
+		while ((int)thread->m_fetch.size() + 1 < m_batch && !empty()) {
+			thread->m_fetch.push_back(next_task(now));
+		}
+		/** task remain, pass wakeup to other */
+		if (!empty()) {
+			m_cond.signal_one();
+		}
 		//assert(task->refer() > 0);
-		debug("next task, thread " << thread->index() << " fetch, total " << count());
+		debug("next task, thread " << thread->index() << " fetch " << thread->m_fetch.size() + 1
+			<< ", total " << count());
 	}
 	#if TIME_RECORD
 		thread->m_times.next("fetch task");
 	#endif
 	//log_info("wait time " << string_timer(ctime_now() - task->m_time));
 
-	task_work(task, thread);
-	dec_count(1);
+	batch_work(task, thread);
 
 	#if TIME_RECORD
 		thread->m_times.next("work task", 10000);
@@ -349,6 +597,239 @@ ThreadPool::thread_wait(Thread* thread)
 	}
 }
 
+ThreadPool::Thread*&
+ThreadPool::local()
+{
+	static thread_local Thread* s_thread = NULL;
+	return s_thread;
+}
+
+bool
+ThreadPool::next_steal(Thread* thread)
+{
+	Task* task = NULL;
+	while (true) {
+		if (!running()) {
+			debug("next task, thread " << thread->index() << " already stop, exit");
+			return false;
+		}
+		if ((task = steal_task(thread))) {
+			break;
+		}
+		if (thread->m_waking) {
+			waking_done(thread, false);
+		}
+		steal_wait(thread);
+	}
+	if (thread->m_waking) {
+		waking_done(thread, true);
+	}
+
+	task_work(task, thread);
+	dec_count(1);
+
+	debug("next task, thread " << thread->index() << " complete, total " << count());
+	return true;
+}
+
+void
+ThreadPool::batch_work(Task* task, Thread* thread)
+{
+	task_work(task, thread);
+	for (auto next : thread->m_fetch) {
+		if (working()) {
+			task_work(next, thread);
+		} else {
+			cycle_task(next, ECANCELED);
+		}
+	}
+	int64_t size = thread->m_fetch.size() + 1;
+	thread->m_fetch.clear();
+	dec_count(size);
+}
+
+ThreadPool::Task*
+ThreadPool::steal_task(Thread* thread)
+{
+	Task* task = NULL;
+	/** poll shared deque at times, or task there starve when local busy */
+	if (thread->m_poll.check() && (task = shared_task(thread))) {
+		return task;
+	}
+	if ((task = thread->m_deque.pop()) || (task = shared_task(thread))) {
+		return task;
+	}
+
+	int size = (int)m_threads.size();
+	int start = (int)(thread->random() % size);
+	for (int i = 0; i < size; i++) {
+		Thread* victim = m_threads[(start + i) % size];
+		if (victim != thread && (task = victim->m_deque.steal())) {
+			thread->m_steal++;
+			return task;
+		}
+	}
+	return NULL;
+}
+
+ThreadPool::Task*
+ThreadPool::shared_task(Thread* thread)
+{
+	if (atomic_load_acquire(&m_shared) == 0) {
+		return NULL;
+	}
+	Task* task = NULL;
+	do {
+		Mutex::Locker lock(m_mutex);
+		if (empty()) {
+			return NULL;
+		}
+		ctime_t now = m_classed ? ctime_now() : 0;
+		task = next_task(now);
+		while ((int)thread->m_fetch.size() + 1 < m_batch && !empty()) {
+			thread->m_fetch.push_back(next_task(now));
+		}
+	} while (0);
+
+	if (thread->m_fetch.empty()) {
+		return task;
+	}
+	/** batch remain put to local deque, others can steal; lifo, push reverse */
+	for (auto it = thread->m_fetch.rbegin(); it != thread->m_fetch.rend(); it++) {
+		thread->m_deque.push(*it);
+	}
+	thread->m_fetch.clear();
+	atomic_fence();
+	if (atomic_load_acquire(&m_idle) > 0 && atomic_load_acquire(&m_waking) == 0) {
+		wakeup_one();
+	}
+	return task;
+}
+
+bool
+ThreadPool::steal_empty()
+{
+	if (atomic_load_acquire(&m_shared) > 0) {
+		return false;
+	}
+	for (auto thread : m_threads) {
+		if (!thread->m_deque.empty()) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void
+ThreadPool::steal_wait(Thread* thread)
+{
+	int signal = thread->m_signal;
+	do {
+		Mutex::Locker lock(m_mutex);
+		if (!running()) {
+			return;
+		}
+		thread->m_parked = true;
+		m_parked.push_back(thread);
+		m_idle++;
+	} while (0);
+
+	/** idle store visible before check task, pair with add */
+	atomic_fence();
+	if (!steal_empty() || !running()) {
+		unpark(thread);
+		return;
+	}
+
+	int wait = thread->wait_time();
+	if (wait == 0 || !futex_wait(&thread->m_signal, signal, wait)) {
+		if (unpark(thread)) {
+			debug("thread wait, thread " << thread->index()
+				<< " wakeup for schedule, set time " << wait << " actual " << thread->timer().elapse());
+			/** wakeup for timeout */
+			thread->schedule(true);
+		}
+		return;
+	}
+	/** wakeup by others already unparked, or interrupted */
+	unpark(thread);
+}
+
+bool
+ThreadPool::unpark(Thread* thread)
+{
+	Mutex::Locker lock(m_mutex);
+	if (!thread->m_parked) {
+		return false;
+	}
+	for (auto it = m_parked.begin(); it != m_parked.end(); it++) {
+		if (*it == thread) {
+			m_parked.erase(it);
+			break;
+		}
+	}
+	thread->m_parked = false;
+	m_idle--;
+	return true;
+}
+
+void
+ThreadPool::wakeup_one()
+{
+	Mutex::Locker lock(m_mutex);
+	/** waking one will wakeup next if task remain, no herd */
+	if (m_parked.empty() || m_waking) {
+		return;
+	}
+	/** last parked first, its cache may still warm */
+	Thread* thread = m_parked.back();
+	m_parked.pop_back();
+	thread->m_parked = false;
+	thread->m_waking = true;
+	m_waking = 1;
+	m_idle--;
+
+	at_inc(thread->m_signal);
+	syscall(SYS_futex, &thread->m_signal, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+void
+ThreadPool::waking_done(Thread* thread, bool task)
+{
+	thread->m_waking = false;
+	atomic_store_release(&m_waking, 0);
+	/** waking clear visible before check task, pair with add */
+	atomic_fence();
+	if (task && atomic_load_acquire(&m_idle) > 0 && !steal_empty()) {
+		wakeup_one();
+	}
+}
+
+void
+ThreadPool::wakeup_all()
+{
+	Mutex::Locker lock(m_mutex);
+	for (auto thread : m_parked) {
+		thread->m_parked = false;
+		at_inc(thread->m_signal);
+		syscall(SYS_futex, &thread->m_signal, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+	}
+	m_parked.clear();
+	m_idle = 0;
+}
+
+int
+ThreadPool::pending()
+{
+	int size = (int)m_shared;
+	if (m_mode == SM_steal) {
+		for (auto thread : m_threads) {
+			size += (int)thread->m_deque.size();
+		}
+	}
+	return size;
+}
+
 void
 ThreadPool::dec_count(int64_t size)
 {
@@ -362,16 +843,37 @@ ThreadPool::clear(int error)
 {
 	Mutex::Locker lock(m_mutex);
 
-	size_t size = m_prior.size() + m_tasks.size();
+	size_t size = m_prior.size();
 	for (auto& task : m_prior) {
 		cycle_task(task, error);
 	}
 	m_prior.clear();
 
-	for (auto& task : m_tasks) {
-		cycle_task(task, error);
+	for (auto& klass : m_class) {
+		size += klass.size();
+		for (auto& task : klass.tasks) {
+			cycle_task(task, error);
+		}
+		klass.tasks.clear();
+
+		for (auto& task : klass.timed) {
+			cycle_task(task, error);
+		}
+		klass.timed.clear();
+		klass.aged.clear();
+	}
+	m_shared = 0;
+
+	/** steal is safe with owner working */
+	for (auto thread : m_threads) {
+		Task* task = NULL;
+		while ((task = thread->m_deque.steal()) || !thread->m_deque.empty()) {
+			if (task) {
+				cycle_task(task, error);
+				size++;
+			}
+		}
 	}
-	m_tasks.clear();
 
 	dec_count((int64_t)size);
 	trace("clear task, set as error " << error << ", remain " << count());
@@ -422,7 +924,10 @@ void main_loop()
 };
 
 #if COMMON_TEST
+#include <thread>
 #include "Common/Display.hpp"
+#include "Common/Future.hpp"
+#include "Perform/Timer.hpp"
 //#include <functional>
 
 namespace common {
@@ -490,13 +995,366 @@ namespace tester {
 	thread_pool_test()
 	{
 		ThreadParam s_param;
-		common::ThreadPool pool("test", new common::TypeTaskManage<NewTask>());
-		pool.start<ThreadTest>(100, s_param, 2);
+		for (int mode = common::ThreadPool::SM_shared; mode <= common::ThreadPool::SM_steal; mode++) {
+			common::ThreadPool pool("test", new common::TypeTaskManage<NewTask>());
+			pool.mode(mode);
+			pool.start<ThreadTest>(100, s_param, 2);
+
+			for (int i = 0; i < 10000; i++) {
+				pool.add((void*)NULL);
+			}
+			pool.stop(true);
+			success(pool.done() == 10000);
+		}
+	}
+
+	/**
+	 * tiny task, spawn child in heap index tree if set
+	 **/
+	class BenchTask : public common::ThreadPool::Task
+	{
+	public:
+		virtual bool operator ()();
+
+	public:
+		int64_t	m_index = {0};
+		int64_t	m_value = {0};
+	};
+
+	/**
+	 * task kept by bench, never free
+	 **/
+	class BenchTaskManage : public common::ThreadPool::TaskManage
+	{
+	public:
+		virtual common::ThreadPool::Task* malloc(void* context) { return NULL; }
 
-		for (int i = 0; i < 10000; i++) {
-			pool.add((void*)NULL);
+		virtual void cycle(common::ThreadPool::Task* task, int eno = 0) {}
+	};
+
+	struct PoolBench
+	{
+		common::ThreadPool* pool = {NULL};
+		std::vector<BenchTask> tasks;
+		bool	spawn = {false};
+		int		batch = {1};
+	} s_pool_bench;
+
+	bool
+	BenchTask::operator ()()
+	{
+		int64_t value = m_index;
+		for (int i = 0; i < 16; i++) {
+			value = value * 31 + i;
+		}
+		m_value = value;
+
+		if (s_pool_bench.spawn) {
+			int64_t total = (int64_t)s_pool_bench.tasks.size();
+			common::ThreadPool::Task* child[2];
+			int count = 0;
+			for (int64_t index = m_index * 2 + 1; index <= m_index * 2 + 2 && index < total; index++) {
+				child[count++] = &s_pool_bench.tasks[index];
+			}
+			if (s_pool_bench.batch > 1) {
+				s_pool_bench.pool->add_batch(child, count);
+			} else {
+				for (int i = 0; i < count; i++) {
+					s_pool_bench.pool->add(child[i]);
+				}
+			}
 		}
+		return true;
+	}
+
+	/**
+	 * run all task, external: add by main thread; spawn: add by task
+	 * @param batch worker fetch count, and add in batch if > 1
+	 **/
+	void
+	__pool_bench(int mode, bool spawn, int thread, int batch)
+	{
+		BenchTaskManage manage;
+		common::ThreadPool pool("bench", &manage);
+		pool.mode(mode);
+		pool.batch(batch);
+		pool.start(thread);
+		s_pool_bench.pool = &pool;
+		s_pool_bench.spawn = spawn;
+		s_pool_bench.batch = batch;
+		int64_t total = (int64_t)s_pool_bench.tasks.size();
+
+		CREATE_TIMER;
+		if (spawn) {
+			pool.add(&s_pool_bench.tasks[0]);
+		} else if (batch > 1) {
+			const int64_t size = 64;
+			std::vector<common::ThreadPool::Task*> array(size);
+			for (int64_t i = 0; i < total; i += size) {
+				int count = (int)std::min(size, total - i);
+				for (int n = 0; n < count; n++) {
+					array[n] = &s_pool_bench.tasks[i + n];
+				}
+				pool.add_batch(&array[0], count);
+			}
+		} else {
+			for (auto& task : s_pool_bench.tasks) {
+				pool.add(&task);
+			}
+		}
+		while (pool.count() > 0) {
+			usleep(100);
+		}
+		ctime_t time = std::max(timer.check(), (ctime_t)1);
+		success(pool.done() == total);
+		pool.stop();
+
+		char line[256];
+		snprintf(line, sizeof(line), "{\"bench\":\"pool_%s\",\"mode\":\"%s\",\"thread\":%d,\"batch\":%d,\"mops\":%.3f}",
+			spawn ? "spawn" : "external", mode == common::ThreadPool::SM_steal ? "steal" : "shared",
+			thread, batch, (double)total / time);
+		printf("%s\n", line);
+		log_info(line);
+	}
+
+	void
+	thread_pool_bench_test()
+	{
+		s_pool_bench.tasks.resize(1 << 20);
+		for (size_t i = 0; i < s_pool_bench.tasks.size(); i++) {
+			s_pool_bench.tasks[i].m_index = i;
+		}
+		int limit = std::max(8, (int)std::thread::hardware_concurrency() * 2);
+		/** result start from new line */
+		printf("\n");
+
+		for (int spawn = 0; spawn < 2; spawn++) {
+			for (int thread = 1; thread <= limit; thread <<= 1) {
+				for (int batch : { 1, 16 }) {
+					__pool_bench(common::ThreadPool::SM_shared, spawn, thread, batch);
+					__pool_bench(common::ThreadPool::SM_steal, spawn, thread, batch);
+				}
+			}
+		}
+	}
+
+	/**
+	 * record run order, the first one block until open
+	 **/
+	class OrderTask : public common::ThreadPool::Task
+	{
+	public:
+		virtual bool operator ()() {
+			while (m_gate && !s_open) {
+				usleep(100);
+			}
+			if (!m_gate) {
+				s_order.push_back(this);
+			}
+			return true;
+		}
+
+	public:
+		bool	m_gate = {false};
+		int		m_tag = {0};
+
+		static volatile bool s_open;
+		static std::vector<OrderTask*> s_order;
+	};
+	volatile bool OrderTask::s_open = false;
+	std::vector<OrderTask*> OrderTask::s_order;
+
+	/**
+	 * queue tasks behind gate, then run in one thread
+	 * @param split tasks after split queued 1 ms later
+	 **/
+	void
+	__class_run(common::ThreadPool& pool, std::vector<OrderTask>& tasks, int block, size_t split = 0, bool front = false)
+	{
+		OrderTask gate;
+		gate.m_gate = true;
+		OrderTask::s_open = false;
+		OrderTask::s_order.clear();
+
+		pool.start(1);
+		pool.add(&gate);
+		for (size_t i = 0; i < tasks.size(); i++) {
+			if (i == split && split > 0) {
+				usleep(c_time_level[0]);
+			}
+			pool.add(&tasks[i], front);
+		}
+		usleep(block * c_time_level[0]);
+		OrderTask::s_open = true;
+		pool.stop(true);
+		success(OrderTask::s_order.size() == tasks.size());
+	}
+
+	void
+	thread_pool_class_test()
+	{
+		BenchTaskManage manage;
+		/** weight 4:1, first 50 run has 40 of class 0 */
+		do {
+			common::ThreadPool pool("class", &manage);
+			pool.classes({4, 1});
+			std::vector<OrderTask> tasks(250);
+			for (size_t i = 0; i < tasks.size(); i++) {
+				tasks[i].priority(i < 50 ? 1 : 0);
+			}
+			__class_run(pool, tasks, 10);
+
+			int count = 0;
+			for (int i = 0; i < 50; i++) {
+				count += OrderTask::s_order[i]->priority() == 0;
+			}
+			log_info("thread pool class, weight 4:1, class 0 run " << count << " of first 50, " << pool.dump_class());
+			success(count >= 39 && count <= 41);
+		} while (0);
+
+		/** earliest deadline first, then task without deadline */
+		do {
+			common::ThreadPool pool("class", &manage);
+			pool.classes({1});
+			std::vector<OrderTask> tasks(100);
+			ctime_t now = ctime_now();
+			for (size_t i = 0; i < tasks.size(); i++) {
+				tasks[i].m_tag = i;
+				tasks[i].deadline(i < 10 ? 0 : now + (tasks.size() - i) * c_time_level[1]);
+			}
+			__class_run(pool, tasks, 10);
+
+			for (size_t i = 0; i < tasks.size(); i++) {
+				int tag = OrderTask::s_order[i]->m_tag;
+				success(i < 90 ? tag == 99 - (int)i : tag == (int)i - 90);
+			}
+		} while (0);
+
+		/** class 1 waited over starve limit, run before class 0 */
+		do {
+			common::ThreadPool pool("class", &manage);
+			pool.classes({100, 1}, 20);
+			std::vector<OrderTask> tasks(20);
+			for (size_t i = 0; i < tasks.size(); i++) {
+				tasks[i].priority(i < 10 ? 1 : 0);
+			}
+			__class_run(pool, tasks, 30, 10);
+
+			for (size_t i = 0; i < 10; i++) {
+				success(OrderTask::s_order[i]->priority() == 1);
+			}
+			log_info("thread pool class, starve, " << pool.dump_class());
+		} while (0);
+
+		/** add front by default, class still fifo, the oldest starved first */
+		do {
+			common::ThreadPool pool("class", &manage);
+			pool.classes({1, 100}, 20);
+			std::vector<OrderTask> tasks(20);
+			ctime_t now = ctime_now();
+			for (size_t i = 0; i < tasks.size(); i++) {
+				tasks[i].m_tag = i;
+				tasks[i].priority(i < 10 ? 0 : 1);
+				/** old ones with far deadline, not seen by deadline order */
+				tasks[i].deadline(i < 5 ? now + 10 * c_time_level[1] : 0);
+			}
+			__class_run(pool, tasks, 30, 10, true);
+
+			for (size_t i = 0; i < 10; i++) {
+				success(OrderTask::s_order[i]->priority() == 0);
+			}
+			for (size_t i = 5; i < 10; i++) {
+				success(OrderTask::s_order[i]->m_tag == (int)i);
+			}
+		} while (0);
+	}
+
+	/**
+	 * write, fsync and commit of one object, stage in order
+	 **/
+	struct PipeObject
+	{
+		int		stage = {0};
+		bool	order = {true};
+
+		int		next(int expect) {
+			order = order && stage == expect;
+			return ++stage;
+		}
+	};
+
+	void
+	future_test()
+	{
+		common::ThreadPool pool("future");
+		pool.start(4);
+
+		/** submit and get */
+		do {
+			auto future = pool.submit([]() { return 42; });
+			success(future.get() == 42 && future.error() == 0);
+
+			volatile int count = 0;
+			std::vector<Future<void>> list;
+			for (int i = 0; i < 100; i++) {
+				list.push_back(pool.submit([&count]() { atomic_inc(&count); }));
+			}
+			success(when_all(list).wait() == 0 && count == 100);
+		} while (0);
+
+		/** predecessor done, continuation run at once in caller */
+		do {
+			std::thread::id caller = std::this_thread::get_id();
+			std::thread::id runner;
+			auto future = make_future(1).then([&runner](int value) {
+				runner = std::this_thread::get_id();
+				return value + 1;
+			});
+			success(future.done() && future.get() == 2 && runner == caller);
+		} while (0);
+
+		/** pipeline, write in pool, fsync inline, commit in pool, no thread wait */
+		do {
+			common::ThreadPool commit("commit");
+			commit.start(1);
+
+			std::vector<PipeObject> objects(1000);
+			std::vector<Future<int>> list;
+			for (auto& object : objects) {
+				PipeObject* curr = &object;
+				list.push_back(pool.submit([curr]() { return curr->next(0); })
+					.then([curr](int stage) { return curr->next(stage); })
+					.then(commit, [curr](int stage) { return curr->next(stage); }));
+			}
+			success(when_all(list).wait() == 0);
+			for (size_t i = 0; i < objects.size(); i++) {
+				success(objects[i].stage == 3 && objects[i].order && list[i].get() == 3);
+			}
+			commit.stop(true);
+		} while (0);
+
+		/** any done, the one done first */
+		do {
+			std::vector<Future<int>> list;
+			list.push_back(pool.submit([]() { usleep(c_time_level[1] / 10); return 0; }));
+			list.push_back(make_future(1));
+			auto any = when_any(list);
+			success(any.done() && any.get() == 1);
+			success(when_any(std::vector<Future<int>>()).error() == EINVAL);
+			list[0].wait();
+		} while (0);
+
+		/** pool stopped, task cancelled, continuation skipped and error passed */
+		do {
+			common::ThreadPool stopped("stopped");
+			bool run = false;
+			auto future = stopped.submit([&run]() { run = true; return 1; })
+				.then([&run](int value) { run = true; return value; });
+			success(future.wait() == ECANCELED && !run && future.get() == 0);
+		} while (0);
+
 		pool.stop(true);
+		log_info("future test done");
 	}
 }
 }
@@ -3,11 +3,15 @@
 
 #include <vector>
 #include <deque>
+#include <set>
 #include <tuple>
+#include <type_traits>
 
 #include "Common/Time.hpp"
 #include "Common/ThreadBase.hpp"
+#include "Common/Topology.hpp"
 #include "CodeHelper/Refer.hpp"
+#include "Advance/StealDeque.hpp"
 
 #define TIME_RECORD 0
 
@@ -18,13 +22,16 @@
 namespace common {
 	typedef void(thread_handle_t)(void* arg);
 
+	template<class T> class Future;
+
 	class ThreadPool
 	{
 	public:
 		class TaskManage;
+		class Task;
 
 		ThreadPool(const char* name = "", TaskManage* manage = NULL)
-			: m_taskm(manage) { set_name(name); }
+			: m_taskm(manage), m_class(1) { set_name(name); }
 
 		virtual ~ThreadPool() { stop(); }
 
@@ -38,6 +45,16 @@ namespace common {
 			ST_stop,
 		};
 
+		/**
+		 * schedule mode, select before start
+		 **/
+		enum {
+			/** shared deque, one mutex */
+			SM_shared = 0,
+			/** worker local deque, steal when empty */
+			SM_steal,
+		};
+
 	public:
 		/**
 		 * cycle counter
@@ -80,7 +97,7 @@ namespace common {
 		{
 		public:
 			Thread(ThreadPool* pool, int index)
-				: m_pool(pool), m_index(index) {}
+				: m_pool(pool), m_index(index), m_random(index * 0x9E3779B97F4A7C15ULL + 1) {}
 
 		public:
 			/**
@@ -120,6 +137,11 @@ namespace common {
 			 **/
 			ThreadPool* pool() { return m_pool; }
 
+			/**
+			 * get task count stolen from others
+			 **/
+			int64_t	stolen() { return m_steal; }
+
 			/**
 			 * set timer
 			 **/
@@ -153,6 +175,16 @@ namespace common {
 			 **/
 			void	schedule(bool force = false);
 
+			/**
+			 * get next random, for steal victim
+			 **/
+			uint64_t random() {
+				m_random ^= m_random << 13;
+				m_random ^= m_random >> 7;
+				m_random ^= m_random << 17;
+				return m_random;
+			}
+
 			friend class ThreadPool;
 
 		protected:
@@ -164,6 +196,22 @@ namespace common {
 			TimeCheck 	m_timer;
 			/** cycle counter */
 			Cycle		m_cycle = {1};
+			/** local task deque, steal mode */
+			StealDeque<Task> m_deque;
+			/** poll shared deque after some local task, steal mode */
+			Cycle		m_poll = {61};
+			/** wakeup futex, steal mode */
+			volatile int m_signal = {0};
+			/** parked or not, protect by pool mutex */
+			bool		m_parked = {false};
+			/** wakeup by task added, not get task yet */
+			bool		m_waking = {false};
+			/** random state */
+			uint64_t	m_random;
+			/** task stolen from others */
+			int64_t		m_steal = {0};
+			/** task fetched in batch, not run yet */
+			std::vector<Task*> m_fetch;
 
 			#if TIME_RECORD
 			StadgeTimer m_times;
@@ -189,6 +237,51 @@ namespace common {
 				assert(0);
 				return true;
 			}
+
+		public:
+			/**
+			 * set priority class, class over pool setting as the last one
+			 * @note priority and deadline ignored if pool classes not set
+			 **/
+			void	priority(int value) { m_priority = value; }
+
+			/**
+			 * get priority class
+			 **/
+			int		priority() { return m_priority; }
+
+			/**
+			 * set deadline, time as ctime_now, 0 for none
+			 **/
+			void	deadline(ctime_t value) { m_deadline = value; }
+
+			/**
+			 * get deadline
+			 **/
+			ctime_t	deadline() { return m_deadline; }
+
+			/**
+			 * get time queued
+			 **/
+			ctime_t	queued() { return m_queued; }
+
+		protected:
+			/**
+			 * task not managed by TaskManage, free itself after work or cancel
+			 * @param eno error if task cancelled, 0 if done
+			 **/
+			virtual void release(int eno) { assert(0); }
+
+			friend class ThreadPool;
+
+			/** priority class */
+			int		m_priority = {0};
+			/** deadline, 0 for none */
+			ctime_t	m_deadline = {0};
+			/** time queued in pool */
+			ctime_t	m_queued = {0};
+			/** run and release by itself, not by TaskManage */
+			bool	m_alone = {false};
 		};
 
 		/**
@@ -225,6 +318,64 @@ namespace common {
 		 **/
 		void	manage(TaskManage* manage) { m_taskm = manage; }
 
+		/**
+		 * set schedule mode, only before start
+		 **/
+		int		mode(int mode) {
+			Mutex::Locker lock(m_mutex);
+			if (running()) {
+				return -1;
+			}
+			m_mode = mode;
+			return 0;
+		}
+
+		/**
+		 * get schedule mode
+		 **/
+		int		mode() { return m_mode; }
+
+		/**
+		 * set max task fetched by worker each lock
+		 **/
+		void	batch(int count) { m_batch = std::max(count, 1); }
+
+		/**
+		 * get max task fetched each lock
+		 **/
+		int		batch() { return m_batch; }
+
+		/**
+		 * set priority class weight, task priority is class index, only before start
+		 * @param starve task waited longer served first, ms, 0 for no limit
+		 * @note weighted fair between class, earliest deadline first in class, task
+		 * without deadline after those with, fifo; not set, pool is plain fifo
+		 * and not record queue time
+		 **/
+		int		classes(const std::vector<int>& weight, int starve = 0);
+
+		/**
+		 * get queue wait of each class since last dump
+		 **/
+		std::string dump_class(bool reset = true);
+
+		/**
+		 * set thread placement, only before start
+		 **/
+		int		placement(const Placement& place) {
+			Mutex::Locker lock(m_mutex);
+			if (running()) {
+				return -1;
+			}
+			m_place = place;
+			return 0;
+		}
+
+		/**
+		 * get placement of each thread, such as spread, 0@cpu0/node0 1@cpu8/node1
+		 **/
+		std::string dump_place();
+
 		/**
 		 * start thread pool
 		 **/
@@ -240,8 +391,12 @@ namespace common {
 				//std::make_tuple(std::ref(args)...)
 				//thread->set(std::make_tuple(args...));
 				thread->set(args...);
+				thread->set_cpu(m_place.cpu(i));
 
 				insert_thread(thread);
+			}
+			/** all thread inserted before create, thread list used when steal */
+			for (auto thread : m_threads) {
 				int ret = thread->create();
 				assert(ret == 0);
 			}
@@ -272,13 +427,28 @@ namespace common {
 		/**
 		 * add new task entry
 		 **/
-		int		add(Task* task, bool front = true);
+		int		add(Task* task, bool front = true) {
+			return add_batch(&task, 1, front);
+		}
+
+		/**
+		 * add tasks in one lock and one wakeup, tasks[0] run first
+		 * @note front ignored if classes set, task queued fifo in class
+		 **/
+		int		add_batch(Task** tasks, int count, bool front = true);
 
 		/**
 		 * put task back to queue
 		 **/
 		int		add_prior(Task* task, bool front = false);
 
+		/**
+		 * run callable in pool, no TaskManage needed, defined in Common/Future.hpp
+		 * @return future of callable result, error ECANCELED if pool not working
+		 **/
+		template<class F>
+		auto	submit(F&& func) -> Future<typename std::result_of<F&()>::type>;
+
 		/**
 		 * get current task count
 		 **/
@@ -287,7 +457,7 @@ namespace common {
 		/**
 		 * get current run count
 		 **/
-		int		run_count() { return count() - m_prior.size() - m_tasks.size(); }
+		int		run_count() { return count() - pending(); }
 
 		/**
 		 * get done count
@@ -298,6 +468,7 @@ namespace common {
 		 * thread working
 		 **/
 		void	thread(Thread* thread) {
+			local() = thread;
 			while (next(thread)) {
 				thread->schedule();
 			}
@@ -334,6 +505,57 @@ namespace common {
 		 **/
 		bool	next(Thread* thread);
 
+		/**
+		 * fetch next task and run, steal mode
+		 **/
+		bool	next_steal(Thread* thread);
+
+		/**
+		 * get task from local, shared deque, or steal from others
+		 **/
+		Task*	steal_task(Thread* thread);
+
+		/**
+		 * get task from shared deque, batch remain put to local deque, steal mode
+		 **/
+		Task*	shared_task(Thread* thread);
+
+		/**
+		 * check if no task any where, steal mode
+		 **/
+		bool	steal_empty();
+
+		/**
+		 * park thread until wakeup, steal mode
+		 **/
+		void	steal_wait(Thread* thread);
+
+		/**
+		 * remove thread from parked list
+		 * @return true if still parked, not wakeup by others
+		 **/
+		bool	unpark(Thread* thread);
+
+		/**
+		 * wakeup one parked thread if no one waking, steal mode
+		 **/
+		void	wakeup_one();
+
+		/**
+		 * waking thread get task or park again, wakeup next if task remain
+		 **/
+		void	waking_done(Thread* thread, bool task);
+
+		/**
+		 * wakeup all parked thread, steal mode
+		 **/
+		void	wakeup_all();
+
+		/**
+		 * get pool thread of current thread
+		 **/
+		static Thread*& local();
+
 		/**
 		 * thread wait
 		 **/
@@ -343,27 +565,57 @@ namespace common {
 		 * do task work
 		 **/
 		void    task_work(Task* task, Thread* thread) {
-			m_taskm->work(task, thread);
+			if (task->m_alone) {
+				(*task)();
+			} else {
+				m_taskm->work(task, thread);
+			}
 			cycle_task(task);
 			at_inc64(m_done);
 		}
 
 		/**
-		 * get next task
+		 * do task and batch fetched, cancel fetched if not working
 		 **/
-		Task*	next_task() {
-			task_deque_t& list = m_prior.empty() ?
-				m_tasks : m_prior;
-			Task* task = *list.begin();
-			list.pop_front();
+		void	batch_work(Task* task, Thread* thread);
+
+		/**
+		 * get next task, now is 0 if classes not set
+		 **/
+		Task*	next_task(ctime_t now) {
+			if (m_prior.empty()) {
+				return class_task(now);
+			}
+			Task* task = *m_prior.begin();
+			m_prior.pop_front();
+			m_shared--;
 			return task;
 		}
 
+		/**
+		 * get next task of class, by pass, deadline and starve limit
+		 **/
+		Task*	class_task(ctime_t now);
+
+		/**
+		 * put task to its class
+		 **/
+		void	class_push(Task* task, ctime_t now);
+
+		/**
+		 * get task count not running
+		 **/
+		int		pending();
+
 		/**
 		 * cycle current task, mayb error happen
 		 **/
 		void	cycle_task(Task* task, int eno = 0) {
-			m_taskm->cycle(task, eno);
+			if (task->m_alone) {
+				task->release(eno);
+			} else {
+				m_taskm->cycle(task, eno);
+			}
 		}
 
 		/**
@@ -394,7 +646,7 @@ namespace common {
 		/**
 		 * check if task is empty
 		 **/
-		bool	empty() { return m_prior.empty() && m_tasks.empty(); }
+		bool	empty() { return m_shared == 0; }
 
 		/**
 		 * check current status
@@ -415,6 +667,59 @@ namespace common {
 		typedef std::vector<Thread*> thread_queue_t;
 		typedef std::deque<Task*> task_deque_t;
 
+		/** class pass increase each served, divided by weight */
+		static const int64_t c_stride = 1 << 20;
+
+		/**
+		 * earliest deadline first
+		 **/
+		struct Earlier
+		{
+			bool operator()(Task* a, Task* b) const {
+				return a->deadline() != b->deadline() ? a->deadline() < b->deadline() : a < b;
+			}
+		};
+
+		/**
+		 * earliest queued first
+		 **/
+		struct Older
+		{
+			bool operator()(Task* a, Task* b) const {
+				return a->queued() != b->queued() ? a->queued() < b->queued() : a < b;
+			}
+		};
+
+		/**
+		 * task of one priority class
+		 **/
+		struct TaskClass
+		{
+			/**
+			 * task count
+			 **/
+			size_t	size() const { return tasks.size() + timed.size(); }
+
+			/** pass increase each served */
+			int64_t	stride = {c_stride};
+			/** virtual time, class with least served first */
+			int64_t	pass = {0};
+			/** task without deadline, fifo, front is the oldest */
+			task_deque_t tasks;
+			/** task with deadline, by deadline */
+			std::set<Task*, Earlier> timed;
+			/** task with deadline, by queued time, for starve check */
+			std::set<Task*, Older> aged;
+			/** served since last dump */
+			int64_t	count = {0};
+			/** total queue wait since last dump */
+			int64_t	wait = {0};
+			/** max queue wait since last dump */
+			int64_t	most = {0};
+			/** served after deadline since last dump */
+			int64_t	miss = {0};
+		};
+
 		/** mutex for lock */
 	    Mutex 		m_mutex = {"thread pool", true};
 	    /** wakeup condition */
@@ -431,10 +736,30 @@ namespace common {
 	    thread_queue_t	m_threads;
 	    /** task manager */
 	    TaskManage*  m_taskm = {NULL};
-	    /** priority deque */
+	    /** priority deque, before any class */
 	    task_deque_t m_prior;
-	    /** task deque */
-	    task_deque_t m_tasks;
+	    /** task class, index as task priority */
+	    std::vector<TaskClass> m_class;
+	    /** pass of class last served */
+	    int64_t		m_pass = {0};
+	    /** starve limit, us, 0 for no limit */
+	    ctime_t		m_starve = {0};
+	    /** classes set, or plain fifo without queue time */
+	    bool		m_classed = {false};
+	    /** schedule mode */
+	    int			m_mode = {SM_shared};
+	    /** max task fetched each lock */
+	    int			m_batch = {1};
+	    /** thread placement */
+	    Placement	m_place;
+	    /** task count of shared deque, check without lock */
+	    volatile int64_t m_shared = {0};
+	    /** parked thread count, check without lock */
+	    volatile int m_idle = {0};
+	    /** thread wakeup but not get task yet, only one a time */
+	    volatile int m_waking = {0};
+	    /** parked thread */
+	    thread_queue_t m_parked;
 	};
 
 	/**
@@ -0,0 +1,302 @@
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "Common/Topology.hpp"
+
+namespace common {
+
+/**
+ * read first line of sysfs file
+ **/
+static std::string
+read_line(const std::string& path)
+{
+	std::string line;
+	std::ifstream file(path);
+	if (file) {
+		std::getline(file, line);
+	}
+	return line;
+}
+
+std::vector<int>
+Topology::parse_list(const std::string& list)
+{
+	std::vector<int> array;
+	std::stringstream ss(list);
+	std::string part;
+	while (std::getline(ss, part, ',')) {
+		if (part.empty()) {
+			continue;
+		}
+		int beg = 0, end = 0;
+		size_t pos = part.find('-');
+		if (pos == std::string::npos) {
+			beg = end = std::stoi(part);
+		} else {
+			beg = std::stoi(part.substr(0, pos));
+			end = std::stoi(part.substr(pos + 1));
+		}
+		for (int cpu = beg; cpu <= end; cpu++) {
+			array.push_back(cpu);
+		}
+	}
+	return array;
+}
+
+void
+Topology::load()
+{
+	int count = (int)sysconf(_SC_NPROCESSORS_CONF);
+	m_cpu_node.assign(count > 0 ? count : 1, 0);
+
+	std::vector<int> nodes = parse_list(read_line("/sys/devices/system/node/possible"));
+	m_nodes = nodes.empty() ? 1 : nodes.back() + 1;
+	m_node_cpu.resize(m_nodes);
+
+	for (int node : nodes) {
+		std::string path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+		for (int cpu : parse_list(read_line(path))) {
+			if (cpu >= cpus()) {
+				m_cpu_node.resize(cpu + 1, 0);
+			}
+			m_cpu_node[cpu] = node;
+			m_node_cpu[node].push_back(cpu);
+		}
+	}
+	/** no sysfs node info, all cpu on node 0 */
+	if (nodes.empty()) {
+		for (int cpu = 0; cpu < cpus(); cpu++) {
+			m_node_cpu[0].push_back(cpu);
+		}
+	}
+
+	/** isolated or cpuset excluded cpu not in affinity */
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	bool affinity = sched_getaffinity(0, sizeof(set), &set) == 0;
+	m_allowed.assign(cpus(), true);
+	for (int cpu = 0; affinity && cpu < cpus() && cpu < CPU_SETSIZE; cpu++) {
+		m_allowed[cpu] = CPU_ISSET(cpu, &set);
+	}
+
+	/** core index by first sibling, no sysfs info as one cpu one core */
+	m_cpu_core.assign(cpus(), -1);
+	for (int cpu = 0; cpu < cpus(); cpu++) {
+		if (m_cpu_core[cpu] != -1) {
+			continue;
+		}
+		std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/thread_siblings_list";
+		std::vector<int> siblings = parse_list(read_line(path));
+		if (siblings.empty()) {
+			siblings.push_back(cpu);
+		}
+		m_core_cpu.push_back(std::vector<int>());
+		for (int sibling : siblings) {
+			if (sibling < cpus() && m_cpu_core[sibling] == -1) {
+				m_cpu_core[sibling] = (int)m_core_cpu.size() - 1;
+				m_core_cpu.back().push_back(sibling);
+			}
+		}
+	}
+}
+
+std::vector<int>
+Topology::compact(int node)
+{
+	std::vector<int> order;
+	if (node < 0 || node >= nodes()) {
+		return order;
+	}
+	for (size_t rank = 0; ; rank++) {
+		size_t size = order.size();
+		for (int cpu : cpus(node)) {
+			const std::vector<int>& sibling = siblings(cpu);
+			if (rank < sibling.size() && sibling[rank] == cpu && allowed(cpu)) {
+				order.push_back(cpu);
+			}
+		}
+		if (order.size() == size) {
+			break;
+		}
+	}
+	return order;
+}
+
+std::vector<int>
+Topology::spread()
+{
+	std::vector<std::vector<int> > array;
+	size_t most = 0;
+	for (int node = 0; node < nodes(); node++) {
+		array.push_back(compact(node));
+		most = std::max(most, array.back().size());
+	}
+
+	std::vector<int> order;
+	for (size_t index = 0; index < most; index++) {
+		for (auto& list : array) {
+			if (index < list.size()) {
+				order.push_back(list[index]);
+			}
+		}
+	}
+	return order;
+}
+
+int
+Placement::parse(const std::string& value)
+{
+	std::string name = value.substr(0, value.find(':'));
+	std::string param = value.find(':') == std::string::npos ? "" : value.substr(value.find(':') + 1);
+	std::vector<int> order;
+	int policy = placement::PP_none;
+
+	if (name.empty() || name == "none") {
+		policy = placement::PP_none;
+
+	} else if (name == "list") {
+		policy = placement::PP_list;
+		try {
+			for (int cpu : Topology::parse_list(param)) {
+				if (cpu < 0 || cpu >= topology().cpus()) {
+					return -1;
+				}
+				order.push_back(cpu);
+			}
+		} catch (...) {
+			return -1;
+		}
+		if (order.empty()) {
+			return -1;
+		}
+
+	} else if (name == "spread") {
+		policy = placement::PP_spread;
+		order = topology().spread();
+
+	} else if (name == "compact") {
+		policy = placement::PP_compact;
+		int node = 0;
+		try {
+			node = param.empty() ? 0 : std::stoi(param);
+		} catch (...) {
+			return -1;
+		}
+		if (node < 0 || node >= topology().nodes()) {
+			return -1;
+		}
+		order = topology().compact(node);
+
+	} else {
+		return -1;
+	}
+
+	m_policy = policy;
+	m_cpus.swap(order);
+	m_value = value.empty() ? "none" : value;
+	return 0;
+}
+
+Topology&
+topology()
+{
+	static Topology s_topology;
+	return s_topology;
+}
+
+int
+current_node()
+{
+	return topology().node(sched_getcpu());
+}
+
+int
+bind_cpu(int cpu)
+{
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+}
+
+#if COMMON_TEST
+#include <set>
+#include "Common/LogHelper.hpp"
+#include "Common/ThreadPool.hpp"
+
+namespace common {
+namespace tester {
+
+	/**
+	 * record cpu task run on
+	 **/
+	class PlaceTask : public common::ThreadPool::Task
+	{
+	public:
+		PlaceTask(void* param) {}
+
+		virtual bool operator ()() {
+			s_cpu = sched_getcpu();
+			return true;
+		}
+		static int s_cpu;
+	};
+	int PlaceTask::s_cpu = -1;
+
+	void
+	topology_test()
+	{
+		std::vector<int> list = Topology::parse_list("0-3,8,10-11");
+		success(list == std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+
+		Topology& topo = topology();
+		log_info("topology, node " << topo.nodes() << ", core " << topo.cores() << ", cpu " << topo.cpus());
+
+		/** each cpu appear once in spread, and in compact of its node */
+		std::vector<int> order = topo.spread();
+		success(!order.empty());
+		success(std::set<int>(order.begin(), order.end()).size() == order.size());
+		for (int cpu : order) {
+			success(topo.allowed(cpu));
+		}
+		for (int node = 0; node < topo.nodes(); node++) {
+			std::vector<int> compact = topo.compact(node);
+			success(compact.size() <= topo.cpus(node).size());
+			for (int cpu : compact) {
+				success(topo.node(cpu) == node);
+			}
+		}
+		for (int cpu = 0; cpu < topo.cpus(); cpu++) {
+			for (int sibling : topo.siblings(cpu)) {
+				success(topo.core(sibling) == topo.core(cpu));
+			}
+		}
+
+		Placement place;
+		success(place.cpu(0) == -1);
+		success(place.parse("unknown") == -1 && place.policy() == placement::PP_none);
+		success(place.parse("compact:" + std::to_string(topo.nodes())) == -1);
+		success(place.parse("list:" + std::to_string(topo.cpus())) == -1);
+		success(place.parse("spread") == 0 && place.cpu(0) == order[0]);
+		success(place.parse("list:0") == 0 && place.cpu(0) == 0 && place.cpu(5) == 0);
+
+		/** pool thread run on cpu placed */
+		common::ThreadPool pool("place", new common::TypeTaskManage<PlaceTask>());
+		pool.placement(place);
+		pool.start(2);
+		pool.add((void*)NULL);
+		std::string dump = pool.dump_place();
+		pool.stop(true);
+		log_info("topology, pool place " << dump << ", run cpu " << PlaceTask::s_cpu);
+		success(PlaceTask::s_cpu == 0);
+	}
+}
+}
+#endif
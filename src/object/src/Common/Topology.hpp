@@ -0,0 +1,180 @@
+
+#pragma once
+
+#include <vector>
+#include <string>
+
+namespace common {
+
+	namespace placement {
+		/**
+		 * thread placement policy
+		 **/
+		enum Policy {
+			/** not bind, os schedule */
+			PP_none = 0,
+			/** bind to cpu list in order */
+			PP_list,
+			/** round robin over node, physical core before smt sibling */
+			PP_spread,
+			/** fill one node, physical core before smt sibling */
+			PP_compact,
+		};
+	}
+
+	/**
+	 * cpu, core and numa node layout, read from sysfs once
+	 **/
+	class Topology
+	{
+	public:
+		Topology() { load(); }
+
+	public:
+		/**
+		 * numa node count, at least 1
+		 **/
+		int		nodes() { return m_nodes; }
+
+		/**
+		 * cpu count
+		 **/
+		int		cpus() { return (int)m_cpu_node.size(); }
+
+		/**
+		 * get node of cpu, 0 if unknown
+		 **/
+		int		node(int cpu) {
+			return cpu >= 0 && cpu < cpus() ? m_cpu_node[cpu] : 0;
+		}
+
+		/**
+		 * get cpu list of node
+		 **/
+		const std::vector<int>& cpus(int node) { return m_node_cpu[node]; }
+
+		/**
+		 * physical core count
+		 **/
+		int		cores() { return (int)m_core_cpu.size(); }
+
+		/**
+		 * get core of cpu, 0 if unknown
+		 **/
+		int		core(int cpu) {
+			return cpu >= 0 && cpu < cpus() ? m_cpu_core[cpu] : 0;
+		}
+
+		/**
+		 * get smt siblings of cpu, cpu itself included
+		 **/
+		const std::vector<int>& siblings(int cpu) { return m_core_cpu[core(cpu)]; }
+
+		/**
+		 * check if cpu in process affinity, isolated cpu not
+		 **/
+		bool	allowed(int cpu) {
+			return cpu >= 0 && cpu < cpus() && m_allowed[cpu];
+		}
+
+		/**
+		 * cpu order of node, first cpu of each core, then next sibling;
+		 * cpu not allowed skipped
+		 **/
+		std::vector<int> compact(int node);
+
+		/**
+		 * cpu order of all node, take compact order of each node in turn
+		 **/
+		std::vector<int> spread();
+
+	public:
+		/**
+		 * parse cpu list string like 0-3,8,10-11
+		 **/
+		static std::vector<int> parse_list(const std::string& list);
+
+	protected:
+		/**
+		 * load layout from sysfs
+		 **/
+		void	load();
+
+	protected:
+		/** node count */
+		int		m_nodes = { 1 };
+		/** node index for each cpu */
+		std::vector<int> m_cpu_node;
+		/** cpu list for each node */
+		std::vector<std::vector<int> > m_node_cpu;
+		/** core index for each cpu */
+		std::vector<int> m_cpu_core;
+		/** smt sibling list for each core */
+		std::vector<std::vector<int> > m_core_cpu;
+		/** cpu in process affinity when load */
+		std::vector<bool> m_allowed;
+	};
+
+	/**
+	 * thread placement, cpu for each thread index
+	 **/
+	class Placement
+	{
+	public:
+		Placement() {}
+
+	public:
+		/**
+		 * parse placement, none, list:0-3,8, spread or compact:node
+		 * @return -1 if invalid, placement not changed
+		 * @note list can bind isolated cpu, spread and compact not
+		 **/
+		int		parse(const std::string& value);
+
+		/**
+		 * get cpu of thread index, -1 for not bind
+		 **/
+		int		cpu(int index) const {
+			return m_cpus.empty() ? -1 : m_cpus[index % m_cpus.size()];
+		}
+
+		/**
+		 * get policy
+		 **/
+		int		policy() const { return m_policy; }
+
+		/**
+		 * get placement string
+		 **/
+		const std::string& dump() const { return m_value; }
+
+	protected:
+		/** placement policy */
+		int		m_policy = { placement::PP_none };
+		/** cpu order */
+		std::vector<int> m_cpus;
+		/** placement string */
+		std::string m_value = { "none" };
+	};
+
+	/**
+	 * global topology
+	 **/
+	Topology& topology();
+
+	/**
+	 * get numa node of current thread
+	 **/
+	int		current_node();
+
+	/**
+	 * bind current thread to cpu
+	 * @return 0 if success, or error
+	 **/
+	int		bind_cpu(int cpu);
+}
+
+#if COMMON_SPACE
+	using common::Topology;
+	using common::Placement;
+#endif
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <deque>
+#include <memory>
 
 #include "Common/Type.hpp"
 #include "Common/Container.hpp"
@@ -11,11 +12,15 @@ namespace common {
 	 * @brief pt type ptr queue
 	 * @note use condition
 	 */
-	template<class Type>
+	template<class Type, class Alloc = std::allocator<Type> >
 	class TypeQueue
 	{
 	public:
-		typedef typename std::deque<Type> curr_type;
+		TypeQueue() {}
+		TypeQueue(const Alloc& alloc) : m_local(alloc) {}
+
+	public:
+		typedef typename std::deque<Type, Alloc> curr_type;
 		typedef typename curr_type::iterator curr_iter;
 
 		/**
@@ -148,7 +153,7 @@ namespace common {
 		 * @param deq src deq
 		 * @param tail append to tail or head
 		 */
-		void	enque(TypeQueue<Type>& queue, bool tail = true) {
+		void	enque(TypeQueue& queue, bool tail = true) {
 			m_local.insert((!tail ? m_local.begin() : m_local.end()),
 				queue.m_local.begin(), queue.m_local.end());
 			queue.m_local.resize(0);
@@ -37,6 +37,10 @@ struct ObjectConfig
 	struct Writer {
 		/** writer thread */
 		int		thread	= { /*5*/ 2 };
+		/** task fetched by writer thread each lock */
+		int		batch	= { 16 };
+		/** writer thread placement, none, list:0-3, spread or compact:node */
+		string	place	= { "none" };
 		/** unit size */
 		int		unit = { 64 * c_length_1M };
 
@@ -48,8 +52,36 @@ struct ObjectConfig
 		struct IO {
 			bool	sync	= {false};
 			bool	direct	= {/*true*/ false};
+			/** check whole object payload when recover */
+			bool	verify	= {true};
 		} io;
 
+		struct Schedule {
+			/** weight of write task */
+			int		write	= { 8 };
+			/** weight of recover task */
+			int		recover	= { 1 };
+			/** task waited longer served first, ms, 0 for no limit */
+			int		starve	= { 1000 };
+			/** write task deadline after put, ms, 0 for none */
+			int		deadline = { 0 };
+		} schedule;
+
+		struct Codec {
+			/** compress codec type, codec::Type, 0 for raw */
+			int		type	= { 0 };
+			/** object smaller written raw */
+			int		threshold = { c_length_4K };
+		} codec;
+
+		/** process memory mark in MB, 0 for no limit */
+		struct Memory {
+			/** slow down put when exceed */
+			int		soft = {0};
+			/** put and alloc fail when exceed */
+			int		hard = {0};
+		} memory;
+
 	} writer;
 
 	struct Reader {
@@ -111,9 +111,14 @@ main(int argc, char* argv[])
 		("sid", 		PO_INT32(object.global.sid), "server id")
 		("root", 		PO_STRI(object.global.root), "root directory")
 		("wthread", 	PO_INT32(object.writer.thread), "writer thread")
+		("wbatch", 		PO_INT32(object.writer.batch), "task fetched by writer thread each time")
+		("wplace", 		PO_STRI(object.writer.place), "writer thread placement, none, list:0-3, spread or compact:node")
+		("wdeadline", 	PO_INT32(object.writer.schedule.deadline), "write task deadline after put in ms, 0 for none")
 		("unit", 		po::value<string>()->default_value(string_size(object.writer.unit, false)), "unit size")
 		("dio",			PO_BOOL_SET(object.writer.io.direct), "use directo io")
 		("sync",		PO_BOOL_SET(object.writer.io.sync), "use sync io")
+		("mem_soft",	PO_INT32(object.writer.memory.soft), "memory soft mark in MB, slow down put")
+		("mem_hard",	PO_INT32(object.writer.memory.hard), "memory hard mark in MB, put fail")
 
 		("host", 		PO_STRI(object.reader.conn.host), "db host")
 		("user", 		PO_STRI(object.reader.conn.user), "db user")
@@ -5,6 +5,7 @@
 #include "Advance/Pointer.hpp"
 #include "Advance/FastHash.hpp"
 #include "Advance/DynChunk.hpp"
+#include "Advance/MemAccount.hpp"
 #include "UnitTest/Mock.hpp"
 #include "ObjectService/LogWriter.hpp"
 #include "ObjectService/Object.hpp"
@@ -12,18 +13,21 @@
 using namespace common;
 
 const int Object::Head::s_magic[] = {
-	0x000000000L, (int)0x8C9864E0DL, (int)0x912ACD805L, 0x00000000L
+	0x000000000L, (int)0x8C9864E0DL, (int)0x912ACD805L
 };
 
 Object*
 Object::Malloc()
 {
+	/** plain object only made for reader commit and recover */
+	mem_account(account::AT_reader, sizeof(Object));
 	return new Object;
 }
 
 void
 Object::Cycle()
 {
+	mem_account(account::AT_reader, -(int64_t)sizeof(Object));
     delete this;
 }
 
@@ -49,8 +53,13 @@ Object::Head::CheckSize()
 uint32_t
 Object::Head::HeadHash()
 {
-	return ::SuperFastHash(Start(), c_head_fixed_size - sizeof(hash))
-		+ ::SuperFastHash(keyptr, keylen);
+	if (check == hash::CT_legacy) {
+		return ::SuperFastHash(Start(), c_head_legacy_size - sizeof(hash))
+			+ ::SuperFastHash(keyptr, keylen);
+	}
+	uint32_t crc = crc32c(Start(), c_head_legacy_size - sizeof(hash));
+	crc = crc32c(&payload, c_head_fixed_size - c_head_legacy_size, crc);
+	return crc32c(keyptr, keylen, crc);
 }
 
 uint32_t
@@ -60,7 +69,7 @@ Object::Head::LastHash(char* data)
 	if (!data) {
 		data = object->mData.tail()->wpos() - c_page_size;
 	}
-	return ::SuperFastHash(data, block_len);
+	return checksum(check, data, block_len);
 }
 
 void
@@ -73,6 +82,10 @@ Object::Head::Write(char* data, uint32_t total, int32_t off)
 	char* keep = data;
 	keylen = strlen(object->mKey.name);
 	keyptr = object->mKey.name;
+	check = hash::CT_crc32c;
+	payload = object->mCheck;
+	codec = object->mCodec;
+	raw = object->mRaw;
 
 	hash[0] = HeadHash();
 	hash[1] = LastHash();
@@ -86,9 +99,21 @@ Object::Head::Write(char* data, uint32_t total, int32_t off)
 int
 Object::Head::Read(char* data, uint32_t total)
 {
-	memcpy(Start(), data, c_head_fixed_size);
-	keyptr = data + c_head_fixed_size;
-
+	memcpy(Start(), data, c_head_legacy_size);
+	if (check == hash::CT_legacy) {
+		payload = 0;
+		codec = codec::CT_none;
+		raw = length;
+		keyptr = data + c_head_legacy_size;
+
+	} else if (check == hash::CT_crc32c) {
+		memcpy(&payload, data + c_head_legacy_size, c_head_fixed_size - c_head_legacy_size);
+		keyptr = data + c_head_fixed_size;
+
+	} else {
+		log_info("object read head, but checksum type " << check << " unknown");
+		return -1;
+	}
 	uint32_t value = HeadHash();
 	if (value != hash[0]) {
 		log_info("object read head, " << StringObject((*this)) << ", but head hash "
@@ -111,6 +136,17 @@ Object::Head::Last(char* data, uint32_t total)
 	return 0;
 }
 
+int
+Object::Head::Verify(uint32_t value)
+{
+	if (value != payload) {
+		log_info("object verify data, " << StringObject((*this)) << ", but data checksum "
+			<< value << " not match recorded " << payload);
+		return -1;
+	}
+	return 0;
+}
+
 void
 Object::Ajustment()
 {
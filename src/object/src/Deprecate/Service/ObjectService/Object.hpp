@@ -8,6 +8,8 @@
 #include "Common/Atomic.hpp"
 #include "Common/CodeHelper.hpp"
 #include "Advance/DynBuffer.hpp"
+#include "Advance/Hash.hpp"
+#include "Advance/Codec.hpp"
 
 namespace object {
 	const int c_user_name_size 	= 512;
@@ -153,6 +155,11 @@ public:
     	 **/
     	int		Last(char* data, uint32_t total);
 
+    	/**
+    	 * check object payload checksum
+    	 **/
+    	int		Verify(uint32_t value);
+
     	/**
     	 * get head start point
     	 **/
@@ -186,7 +193,9 @@ public:
 
     public:
 		/** head magic */
-    	int 		magic[4] = { s_magic[0], s_magic[1], s_magic[2], s_magic[3] };
+    	int 		magic[3] = { s_magic[0], s_magic[1], s_magic[2] };
+    	/** checksum type, last magic word before, zero for legacy hash */
+    	int32_t		check = { common::hash::CT_crc32c };
     	/** current offset */
     	int32_t	    offset = {0};
     	/** actual data length */
@@ -197,14 +206,21 @@ public:
     	int32_t	    keylen = {0};
     	/** head and block hash for check */
     	uint32_t 	hash[2] = {0};
+    	/** whole data checksum, not exist for legacy */
+    	uint32_t	payload = {0};
+    	/** compress codec, not exist for legacy */
+    	int32_t		codec = {0};
+    	/** data length before compress, not exist for legacy */
+    	int32_t		raw = {0};
 
     	const char*	keyptr  = {NULL};
     	Object*		object 	= {NULL};
 
-		static const int s_magic[object::c_object_magic_size / sizeof(int)];
+		static const int s_magic[object::c_object_magic_size / sizeof(int) - 1];
     };
 	static const int c_head_pos = OFFSET(Head, magic[0]);
-	static const int c_head_fixed_size = OFFSET(Head, keyptr) - c_head_pos;
+	static const int c_head_legacy_size = OFFSET(Head, payload) - c_head_pos;
+	static const int c_head_fixed_size = OFFSET(Head, raw) + sizeof(int32_t) - c_head_pos;
 
 public:
 	/**
@@ -214,6 +230,9 @@ public:
 		SetKey(head.keyptr, head.keylen);
 		mLength = head.length;
 		mActual = head.actual;
+		mCheck = head.payload;
+		mCodec = head.codec;
+		mRaw = head.raw;
 		mLocation.index = index;
 		mLocation.offset = head.offset;
 	}
@@ -244,8 +263,11 @@ public:
 	 * set data value
 	 **/
 	void	SetData(const byte_t* data, uint32_t len) {
-		mData.write(data, len);
+		mCheck = 0;
+		mData.write(data, len, mCheck);
 		mLength = len;
+		mRaw = len;
+		mCodec = common::codec::CT_none;
 	}
 
 	/**
@@ -302,6 +324,12 @@ public:
 	int		mLength = {0};
 	/** occupy length */
 	int		mActual = {0};
+	/** data crc32c, computed when set data */
+	uint32_t mCheck = {0};
+	/** data length before compress */
+	int		mRaw = {0};
+	/** compress codec */
+	int		mCodec = {0};
 	/** reference count */
 	common::Refer mRefer;
 	/** object user */
@@ -1,6 +1,9 @@
 
 #include "ObjectClient.hpp"
 
+#include <cerrno>
+#include <vector>
+
 #include "Advance/TypeAlloter.hpp"
 #include "Perform/StatThread.hpp"
 #include "ObjectService/Control.hpp"
@@ -51,18 +54,60 @@ BaseClient::Put(Context* ctx, bool async)
 
 	ctx->mClient = this;
 	ctx->mUnique = Next();
+	/** ctx may be released by writer on error, keep its id */
+	typeid_t unique = ctx->mUnique;
 
+	int ret = 0;
 	if (async) {
-		mOutstanding.add(ctx->mUnique);
+		mOutstanding.add(unique);
 		lock.unlock();
 
-		Send(ctx);
+		/** writer not take it or cancelled, never done, remove outstanding here */
+		if ((ret = Send(ctx)) != 0) {
+			lock.lock();
+			mOutstanding.del(unique);
+			mCond.signal_all();
+		}
 
-	} else {
-		Send(ctx);
+	} else if ((ret = Send(ctx)) == 0) {
 		mCond.wait_interval(mMutex, s_wait);
 	}
-    return 0;
+
+	/** only not taken by writer, cancelled one already released */
+	if (ret == -ENOMEM) {
+		ctx->mError = ret;
+		ctx->Dec();
+	}
+    return ret;
+}
+
+int
+BaseClient::Put(Context** ctx, int count)
+{
+	Mutex::Locker lock(mMutex);
+	/** ctx may be released by writer on error, keep their id */
+	std::vector<typeid_t> unique(count);
+	for (int i = 0; i < count; i++) {
+		ctx[i]->mClient = this;
+		ctx[i]->mUnique = unique[i] = Next();
+		mOutstanding.add(unique[i]);
+	}
+	lock.unlock();
+
+	int ret = Send(ctx, count);
+	if (ret != 0) {
+		lock.lock();
+		for (int i = 0; i < count; i++) {
+			mOutstanding.del(unique[i]);
+			/** only not taken by writer, cancelled one already released */
+			if (ret == -ENOMEM) {
+				ctx[i]->mError = ret;
+				ctx[i]->Dec();
+			}
+		}
+		mCond.signal_all();
+	}
+	return ret;
 }
 
 void
@@ -130,10 +175,17 @@ BaseClient::WaitOutstanding(size_t count)
 	return ret;
 }
 
-void
+int
 BaseClient::Send(Context* ctx)
 {
-	GetWriter()->Put(ctx);
+	return GetWriter()->Put(ctx);
+}
+
+int
+BaseClient::Send(Context** ctx, int count)
+{
+	std::vector<Object*> objects(ctx, ctx + count);
+	return GetWriter()->Put(&objects[0], count);
 }
 
 #include <sstream>
@@ -173,8 +173,15 @@ public:
 
 	/**
 	 * request context
+	 * @return -ENOMEM if writer reject, ctx not taken; other error ctx released
 	 **/
-	void 	Send(Context* ctx);
+	int 	Send(Context* ctx);
+
+	/**
+	 * request contexts in one writer submit
+	 * @return -ENOMEM if writer reject, none of ctx taken; other error all released
+	 **/
+	int 	Send(Context** ctx, int count);
 
 public:
 	/**
@@ -182,6 +189,12 @@ public:
 	 **/
 	int		Put(Context* ctx, bool async = false);
 
+	/**
+	 * put data in batch, async
+	 * @return error if writer reject or cancel, all ctx released
+	 **/
+	int		Put(Context** ctx, int count);
+
 	/**
 	 * get data
 	 **/
@@ -1,8 +1,10 @@
 
 #include "ObjectTest.hpp"
 
+#include <vector>
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 #include <unistd.h>
 
 #include "Common/Define.hpp"
@@ -84,17 +86,26 @@ ClientTest::PutTest()
 	int klen, dlen;
 
 	uint64_t total = mConfig.EachCount();
+	size_t batch = std::max(mConfig.test.batch, 1);
+	std::vector<Context*> array;
+	array.reserve(batch);
 	for (uint64_t count = 0; count < total; count++) {
-#if !OBJECT_PERFORM
-		WaitOutstanding(mConfig.test.batch);
-#endif
 		mSource.key(key, klen);
 		mSource.get(data, dlen);
 
 		Context* ctx = Context::Malloc();
 		ctx->Set(Context::OP_put);
 		ctx->Data(key, klen, data, dlen);
-		Put(ctx, true);
+		array.push_back(ctx);
+
+		/** one writer submit each batch, wait until under one batch outstanding */
+		if (array.size() == batch || count + 1 == total) {
+#if !OBJECT_PERFORM
+			WaitOutstanding(batch);
+#endif
+			Put(&array[0], array.size());
+			array.clear();
+		}
 	}
 
 	Close();
@@ -22,6 +22,11 @@ ObjectUnit::ObjectUnit(Writer* writer)
 {
 }
 
+ObjectUnit::~ObjectUnit()
+{
+	delete mCodec;
+}
+
 const string&
 ObjectUnit::String()
 {
@@ -157,6 +162,7 @@ int
 ObjectUnit::Prepare(Object* object)
 {
 	mObject = object;
+	Compress(object);
 	object->Ajustment();
 
 	#if OBJECT_PERFORM
@@ -175,6 +181,46 @@ ObjectUnit::Prepare(Object* object)
     return Errno();
 }
 
+int
+ObjectUnit::Compress(Object* object)
+{
+	int type = Config().codec.type;
+	/** already compressed when retry */
+	if (type == codec::CT_none || object->mCodec != codec::CT_none ||
+		object->mLength < Config().codec.threshold)
+	{
+		return 0;
+	}
+
+	if (!mCodec || mCodec->type() != type) {
+		delete mCodec;
+		/** type checked in Writer::Start */
+		if (!(mCodec = Codec::create(type))) {
+			return -1;
+		}
+	}
+
+	uint32_t crc = 0;
+	mCompress.clear();
+	/** data may padded already when retry */
+	length_t size = mCodec->compress(object->mData, mCompress, &crc, object->mLength);
+
+	/** no page saved, keep raw */
+	if (page_align(size) >= page_align(object->mLength)) {
+		mCompress.clear();
+		return 0;
+	}
+	object->mData = std::move(mCompress);
+	object->mLength = size;
+	object->mCodec = type;
+	object->mCheck = crc;
+
+	#if OBJECT_PERFORM
+		mTimer.next("compress");
+	#endif
+	return 0;
+}
+
 void
 ObjectUnit::FileSwitch()
 {
@@ -473,6 +519,13 @@ ObjectUnit::RecoverNext(int64_t pos, Object::Head& head, byte_t* data)
 				log_info("recover object, " << String() << " pos " << pos << ", " << StringObject(head)
 					<< ", object block not valid");
 				break;
+
+			} else if (Config().io.verify && RecoverCheck(pos, head) != 0) {
+				MockWakeup(WT_object_data_crash);
+				writer_inc(WS_recovr_object_data_crash);
+				log_info("recover object, " << String() << " pos " << pos << ", " << StringObject(head)
+					<< ", object data not valid");
+				break;
 			}
 			writer_inc(WS_recovr_read, head.CheckSize());
 
@@ -485,6 +538,38 @@ ObjectUnit::RecoverNext(int64_t pos, Object::Head& head, byte_t* data)
 	return -1;
 }
 
+int
+ObjectUnit::RecoverCheck(int64_t pos, Object::Head& head)
+{
+	/** legacy object have no payload checksum */
+	if (head.check == hash::CT_legacy) {
+		return 0;
+	}
+
+	stack_align(block, c_length_64K, c_page_size);
+	uint32_t crc = 0;
+	int32_t done = 0;
+	pos += object::c_object_head_size;
+
+	while (done < head.actual) {
+		int32_t size = std::min(head.actual - done, (int32_t)c_length_64K);
+		if (mRecover.pread(block, size, pos + done) != size) {
+			writer_inc(WS_recovr_read_failed);
+			log_info("recover object, " << String() << " pos " << pos << ", " << StringObject(head)
+				<< ", read " << pos + done << " size " << size << " but read data failed, " << syserr());
+			return -1;
+		}
+		writer_inc(WS_recovr_read, size);
+
+		/** suffix not checked */
+		if (done < head.length) {
+			crc = crc32c(block, std::min(size, head.length - done), crc);
+		}
+		done += size;
+	}
+	return head.Verify(crc);
+}
+
 int
 WriteData(void* ptr, const byte_t* data, length_t len)
 {
@@ -504,9 +589,7 @@ ObjectUnit::SingleWrite(const byte_t* data, length_t len)
 int
 ObjectUnit::WriteObject()
 {
-	if (WriteHead() != 0 ||
-		WriteData() != 0)
-	{
+	if (WriteVector() != 0) {
 		return Errno();
 	}
 
@@ -514,23 +597,34 @@ ObjectUnit::WriteObject()
 }
 
 int
-ObjectUnit::WriteHead()
+ObjectUnit::WriteVector()
 {
 	#if OBJECT_PERFORM
-		return 0;
-	#endif
+		/** perform mode skip head, data only */
+		return WriteData();
+	#else
 	mHead.object = mObject;
 	stack_align(data, object::c_object_head_size, c_page_size);
 	mHead.Write(data, object::c_object_head_size, mIndex.curr);
 
-	if (mFile.write(data, object::c_object_head_size) != object::c_object_head_size ||
-		MockWakeupEvent(WT_object_write_head))
+	/** head and all data chunk go out in one syscall */
+	Buffer* buffer = &mObject->mData;
+	mIovec.resize(buffer->iovec_count() + 1);
+	mIovec[0].iov_base = data;
+	mIovec[0].iov_len = object::c_object_head_size;
+	int count = buffer->to_iovec(&mIovec[1], mIovec.size() - 1) + 1;
+
+	int64_t total = object::c_object_head_size + buffer->length();
+	if (mFile.writev(&mIovec[0], count) != total ||
+		MockWakeupEvent(WT_object_write_head) ||
+		MockWakeupEvent(WT_object_write_data))
 	{
-        log_warn("write object, " << String() << " pos " << mLength << ", " << StringObject(mHead)
-        	<< ", write head failed, " << syserr());
+		log_warn("write object, " << String() << " pos " << mLength << ", " << StringObject(mHead)
+			<< ", write vector failed, " << syserr());
 		return Errno(OS_object_write);
 	}
 	return 0;
+	#endif
 }
 
 int
@@ -1,6 +1,9 @@
 
 #pragma once
 
+#include <vector>
+#include <sys/uio.h>
+
 #include "ObjectService/Config.hpp"
 #include "ObjectService/Object.hpp"
 #include "Common/File.hpp"
@@ -17,6 +20,8 @@ class ObjectUnit
 public:
 	ObjectUnit(Writer* writer = NULL);
 
+	~ObjectUnit();
+
 	/**
 	 * set writer
 	 **/
@@ -163,11 +168,21 @@ protected:
 	 **/
 	int64_t	RecoverNext(int64_t pos, Object::Head& head, byte_t* data);
 
+	/**
+	 * read object payload, check with head recorded
+	 **/
+	int		RecoverCheck(int64_t pos, Object::Head& head);
+
 	/**
 	 * check state for current object write
 	 **/
 	int		Prepare(Object* object);
 
+	/**
+	 * compress object data if codec set
+	 **/
+	int		Compress(Object* object);
+
 	/**
 	 * refresh local info, alloc new unit
 	 **/
@@ -179,9 +194,9 @@ protected:
 	int		WriteObject();
 
 	/**
-	 * write head
+	 * write head and data in one vector
 	 **/
-	int		WriteHead();
+	int		WriteVector();
 
 	/**
 	 * write data
@@ -232,6 +247,12 @@ protected:
 	string		mString;
 	/** current buffer data */
 	DynBuffer	mData;
+	/** object write vector, head and data chunk */
+	std::vector<struct iovec> mIovec;
+	/** object data codec */
+	Codec*		mCodec = {NULL};
+	/** compress output */
+	DynBuffer	mCompress;
 	/** current buffer pos */
 	int64_t		mPost = {0};
 	#if OBJECT_PERFORM
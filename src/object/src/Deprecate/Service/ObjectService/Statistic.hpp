@@ -45,6 +45,9 @@ enum WriterStatus {
 	WS_object_size,
 	WS_object_size_done,
 
+	WS_object_delay,
+	WS_object_reject,
+
 	WS_recovr_recv,
 	WS_recovr_done,
 
@@ -57,6 +60,7 @@ enum WriterStatus {
 	
 	WS_recovr_object,
 	WS_recovr_object_head_crash,
+	WS_recovr_object_data_crash,
 	WS_recovr_object_trunc,
 
 	WS_recovr_span,
@@ -55,6 +55,7 @@ enum ObjectWaitType {
 	WT_object_parse,
 	WT_object_head_crash,
 	WT_object_block_crash,
+	WT_object_data_crash,
 	WT_object_length_exceed,
 
 	WT_object_write_head,
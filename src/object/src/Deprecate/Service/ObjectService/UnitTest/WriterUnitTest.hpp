@@ -109,7 +109,9 @@ public:
 	void	DoWrite(int count = 0) {
 		do {
 			Object* object = g_source.Next();
-			mWriter.Put(object);
+			if (mWriter.Put(object) == -ENOMEM) {
+				object->Dec();
+			}
 		} while (--count > 0);
 	}
 
@@ -8,6 +8,7 @@
 #include "ObjectService/Statistic.hpp"
 #include "Common/Display.hpp"
 #include "Advance/TypeAlloter.hpp"
+#include "Advance/MemGovernor.hpp"
 #include "UnitTest/Mock.hpp"
 
 
@@ -22,11 +23,11 @@ TaskPool(int type = OT_task)
 {
 	switch (type) {
 	case OT_task: {
-		static TypeAlloter<WriteTask> s_task(4096);
+		static TypeAlloter<WriteTask> s_task(4096, common::wrap::WL_mutex, NULL, common::account::AT_writer);
 		return &s_task;
 	} break;
 	case OT_recover: {
-		static TypeAlloter<RecoverTask> s_task(64);
+		static TypeAlloter<RecoverTask> s_task(64, common::wrap::WL_mutex, NULL, common::account::AT_writer);
 		return &s_task;
 	} break;
 	default: assert(0);
@@ -36,15 +37,33 @@ TaskPool(int type = OT_task)
 }
 
 WriteTask*
-WriteTask::Malloc()
+WriteTask::Malloc(TaskArena* scope)
 {
-	return (WriteTask*)TaskPool()->_new();
+	void* data = scope ? scope->mArena._new(sizeof(WriteTask)) : NULL;
+	if (!data) {
+		if (scope && atomic_add(&scope->mRemain, -1) == 1) {
+			delete scope;
+		}
+		return (WriteTask*)TaskPool()->_new();
+	}
+	WriteTask* task = ::new(data) WriteTask;
+	task->mArena = scope;
+	return task;
 }
 
 void
 WriteTask::cycle()
 {
-	TaskPool()->_del(this);
+	if (!mArena) {
+		TaskPool()->_del(this);
+		return;
+	}
+	/** arena given back with the last task of batch */
+	TaskArena* scope = mArena;
+	this->~WriteTask();
+	if (atomic_add(&scope->mRemain, -1) == 1) {
+		delete scope;
+	}
 }
 
 void
@@ -195,6 +214,26 @@ void
 Writer::Start()
 {
 	//mConfig->writer.thread = 1;
+	common::mem_governor().set((int64_t)Config().memory.soft * c_length_1M,
+		(int64_t)Config().memory.hard * c_length_1M);
+
+	mPool.batch(mConfig->writer.batch);
+	common::Placement place;
+	if (place.parse(mConfig->writer.place) != 0) {
+		log_warn("writer placement " << mConfig->writer.place << " invalid, ignore");
+	}
+	mPool.placement(place);
+
+	/** check codec once, not warn every put */
+	if (Config().codec.type != codec::CT_none) {
+		Codec* check = Codec::create(Config().codec.type);
+		if (!check) {
+			log_warn("writer codec " << Config().codec.type << " not built, write raw");
+			Config().codec.type = codec::CT_none;
+		}
+		delete check;
+	}
+	mPool.classes({Config().schedule.write, Config().schedule.recover}, Config().schedule.starve);
 	int ret = mPool.start<WriteThread>(mConfig->writer.thread, this);
 	if (ret == 0) {
 		mThread.start(GlobalConfig().global.dump, WriterDump);
@@ -222,14 +261,26 @@ Writer::Cancel(int error)
 int
 Writer::Put(Object* object)
 {
+	/** memory pressure, delay admission above soft mark, reject above hard */
+	int level = common::mem_governor().admit();
+	if (level == common::governor::GL_hard) {
+		writer_inc(WS_object_reject);
+		return -ENOMEM;
+
+	} else if (level == common::governor::GL_soft) {
+		writer_inc(WS_object_delay);
+	}
+
 	WriteTask* task = WriteTask::Malloc();
 	task->Set(object);
+	Schedule(task);
 
 	if (mPool.add(task) != 0) {
 		if (change(WT_trace_stop, true)) {
 			log_trace("put task, but pool is stopping");
 		}
-		return -1;
+		/** task cancelled by pool, object released with it */
+		return -ECANCELED;
 	}
 
 	writer_inc(WS_object_recv);
@@ -237,6 +288,54 @@ Writer::Put(Object* object)
 	return 0;
 }
 
+int
+Writer::Put(Object** object, int count)
+{
+	if (count <= 0) {
+		return 0;
+	}
+	int level = common::mem_governor().admit();
+	if (level == common::governor::GL_hard) {
+		writer_inc(WS_object_reject, count);
+		return -ENOMEM;
+
+	} else if (level == common::governor::GL_soft) {
+		writer_inc(WS_object_delay, count);
+	}
+
+	/** one arena for the whole batch, instead of one pool round trip each task */
+	TaskArena* scope = new TaskArena(count);
+	scope->mArena.account(common::account::AT_writer);
+	std::vector<ThreadPool::Task*> tasks(count);
+	int64_t size = 0;
+	for (int i = 0; i < count; i++) {
+		WriteTask* task = WriteTask::Malloc(scope);
+		task->Set(object[i]);
+		Schedule(task);
+		tasks[i] = task;
+		size += object[i]->mLength + c_object_head_size;
+	}
+
+	if (mPool.add_batch(&tasks[0], count) != 0) {
+		if (change(WT_trace_stop, true)) {
+			log_trace("put task, but pool is stopping");
+		}
+		return -ECANCELED;
+	}
+
+	writer_inc(WS_object_recv, count);
+	writer_inc(WS_object_size, size);
+	return 0;
+}
+
+void
+Writer::Schedule(WriteTask* task)
+{
+	task->priority(WC_write);
+	int deadline = Config().schedule.deadline;
+	task->deadline(deadline > 0 ? common::ctime_now() + deadline * c_time_level[0] : 0);
+}
+
 int
 Writer::CommitUnit(const UnitIndex& index)
 {
@@ -261,7 +360,10 @@ Writer::RecoverUnit(const UnitIndex& index)
 	writer_inc(WS_recovr_recv);
 	RecoverTask* task = RecoverTask::Malloc();
 	task->Set(index);
-	mPool.add_prior(task);
+	/** compete with write by class weight, not before all write */
+	task->priority(WC_recover);
+	task->deadline(0);
+	mPool.add(task, false);
 }
 
 int
@@ -278,14 +380,20 @@ Writer::DumpStatus(string& str)
     	"\n\t recover: %8" i64 ", \tcrash: %8" i64 ", \t trunc: %8" i64 ", \t object: %8s"
     	"\n\t                     \t read: %8s, \t span:  %8s, \t trunc:  %8" i64 ", \t fail:  %8" i64
     	"\n\t request: %8" i64 ", \t done: %8s, \t retry: %8" i64 ", \t fail:   %8" i64
-		"\n\t write:   %8s, \t done: %8s",
-		writer_count(WS_recovr_done), writer_count(WS_recovr_head_partial) + writer_count(WS_recovr_object_head_crash),
+		"\n\t write:   %8s, \t done: %8s"
+		"\n\t memory:  %8s, \t delay: %8" i64 ", \t reject: %8" i64
+		"\n\t place:   %s"
+		"\n\t wait:    %s",
+		writer_count(WS_recovr_done), writer_count(WS_recovr_head_partial) + writer_count(WS_recovr_object_head_crash)
+			+ writer_count(WS_recovr_object_data_crash),
 		writer_count(WS_recovr_object_trunc), string_count(writer_count(WS_recovr_object)).c_str(),
 		string_size(writer_count(WS_recovr_read)).c_str(), string_size(writer_count(WS_recovr_span)).c_str(),
 		writer_count(WS_recovr_trunc), writer_count(WS_recovr_read_failed),
 		writer_count(WS_object_recv) - writer_count(WS_object_done), string_count(writer_count(WS_object_done)).c_str(),
         writer_count(WS_object_retry), writer_count(WS_object_fail),
-		string_size(writer_count(WS_object_size) - writer_count(WS_object_size_done)).c_str(), string_size(writer_count(WS_object_size_done)).c_str());
+		string_size(writer_count(WS_object_size) - writer_count(WS_object_size_done)).c_str(), string_size(writer_count(WS_object_size_done)).c_str(),
+		string_size(common::mem_governor().used()).c_str(), writer_count(WS_object_delay), writer_count(WS_object_reject),
+		mPool.dump_place().c_str(), mPool.dump_class().c_str());
 	 return str;
 }
 
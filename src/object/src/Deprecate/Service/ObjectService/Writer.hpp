@@ -7,6 +7,7 @@
 #include "Common/Util.hpp"
 #include "Common/ThreadBase.hpp"
 #include "Common/ThreadPool.hpp"
+#include "Advance/Arena.hpp"
 #include "CodeHelper/Bitset.hpp"
 
 using std::string;
@@ -73,6 +74,18 @@ protected:
 };
 
 
+/**
+ * tasks of one batch put live in one arena, freed with the last task
+ **/
+struct TaskArena
+{
+	TaskArena(int count) : mRemain(count) {}
+
+	common::Arena mArena;
+	/** task not cycled yet */
+	volatile int mRemain = {0};
+};
+
 class WriteTask : public common::ThreadPool::Task
 {
 public:
@@ -83,8 +96,10 @@ public:
 public:
 	/**
 	 * malloc new task
+	 *
+	 * @param scope if set, task memory live in batch arena, pool if arena full
 	 **/
-	static WriteTask* Malloc();
+	static WriteTask* Malloc(TaskArena* scope = NULL);
 
 	/**
 	 * cycle task
@@ -129,6 +144,8 @@ public:
 	bool	mRetry = {false};
 	/** current object */
 	Object* mObject = {NULL};
+	/** batch arena task memory live in */
+	TaskArena* mArena = {NULL};
 	#if OBJECT_PERFORM
 		StadgeTimer mTimer;
 	#endif
@@ -184,6 +201,14 @@ public:
 		WT_null = 0,
 		WT_trace_stop,
 	};
+
+	/**
+	 * task priority class in pool
+	 **/
+	enum WriterClass {
+		WC_write = 0,
+		WC_recover,
+	};
 	/**
 	 * start writer thread
 	 **/
@@ -203,9 +228,18 @@ public:
 
 	/**
 	 * put new object to writer
+	 * @return -ENOMEM if memory over hard mark, object not taken;
+	 * 		   -ECANCELED if writer stopping, object taken and released
 	 **/
 	int		Put(Object* object);
 
+	/**
+	 * put objects to writer in one pool lock, client batch put
+	 * @return -ENOMEM if memory over hard mark, none taken;
+	 * 		   -ECANCELED if writer stopping, all taken and released
+	 **/
+	int		Put(Object** object, int count);
+
 	/**
 	 * get object for read
 	 **/
@@ -258,6 +292,12 @@ public:
 	string&	DumpStatus(string& str);
 
 	BITSET_DEFINE;
+protected:
+	/**
+	 * set write task class and deadline
+	 **/
+	void	Schedule(WriteTask* task);
+
 protected:
 	/** object config */
 	ObjectConfig* mConfig = {NULL};
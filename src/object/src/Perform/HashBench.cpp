@@ -0,0 +1,193 @@
+
+#if COMMON_TEST
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <unordered_set>
+
+#include "Common/LogHelper.hpp"
+#include "Common/Display.hpp"
+#include "Advance/FastHash.hpp"
+#include "Advance/Hash.hpp"
+#include "Perform/Source.hpp"
+#include "Perform/Timer.hpp"
+
+namespace common {
+namespace tester {
+
+	/**
+	 * hash under bench
+	 **/
+	struct BenchHash
+	{
+		const char* name;
+		uint64_t (*hash)(const byte_t* data, size_t len);
+	};
+
+	static const BenchHash s_bench_hash[] = {
+		{ "super_fast", [](const byte_t* data, size_t len) {
+			return (uint64_t)::SuperFastHash((const char*)data, (int)len); } },
+		{ "crc32c_table", [](const byte_t* data, size_t len) {
+			return (uint64_t)crc32c_table(data, len); } },
+		{ "crc32c", [](const byte_t* data, size_t len) {
+			return (uint64_t)crc32c(data, len); } },
+		{ "fast_hash_scalar", [](const byte_t* data, size_t len) {
+			FastHasher hasher(0, false);
+			hasher.update(data, len);
+			return hasher.digest(); } },
+		{ "fast_hash", [](const byte_t* data, size_t len) {
+			return fast_hash(data, len); } },
+	};
+
+	/**
+	 * print one result as json line, for script parse
+	 **/
+	void
+	__bench_output(const char* bench, const char* hash, const char* field, double value,
+		size_t size = 0, int align = -1, const char* source = NULL)
+	{
+		char line[256];
+		int len = snprintf(line, sizeof(line), "{\"bench\":\"%s\",\"hash\":\"%s\"", bench, hash);
+		if (source) {
+			len += snprintf(line + len, sizeof(line) - len, ",\"source\":\"%s\"", source);
+		} else {
+			len += snprintf(line + len, sizeof(line) - len, ",\"size\":%zu,\"align\":%d", size, align);
+		}
+		snprintf(line + len, sizeof(line) - len, ",\"%s\":%.3f}", field, value);
+		printf("%s\n", line);
+		log_info(line);
+	}
+
+	/**
+	 * key hash, independent call for throughput, input offset depend on
+	 * last result for latency
+	 **/
+	void
+	__bench_key(const BenchHash& bench, const std::vector<byte_t>& data, size_t size, int align)
+	{
+		const int64_t count = 1 << 18;
+		const size_t mask = c_length_64K / 2 - 1;
+		const byte_t* base = &data[align];
+		uint64_t value = 0;
+
+		CREATE_TIMER;
+		for (int64_t i = 0; i < count; i++) {
+			value += bench.hash(base + ((i * 64) & mask), size);
+		}
+		ctime_t time = std::max(timer.check(), (ctime_t)1);
+		__bench_output("key_throughput", bench.name, "mops", (double)count / time, size, align);
+
+		for (int64_t i = 0; i < count; i++) {
+			value = bench.hash(base + ((value & 1) << 6), size);
+		}
+		time = std::max(timer.check(), (ctime_t)1);
+		__bench_output("key_latency", bench.name, "ns", (double)time * c_time_level[0] / count, size, align);
+		log_debug("check " << value);
+	}
+
+	/**
+	 * payload hash throughput
+	 **/
+	void
+	__bench_payload(const BenchHash& bench, const std::vector<byte_t>& data, size_t size, int align)
+	{
+		int64_t loop = std::max((int64_t)1, (int64_t)c_length_1M * 128 / (int64_t)size);
+		uint64_t value = 0;
+
+		CREATE_TIMER;
+		for (int64_t i = 0; i < loop; i++) {
+			value += bench.hash(&data[align], size);
+		}
+		ctime_t time = std::max(timer.check(), (ctime_t)1);
+		__bench_output("payload_throughput", bench.name, "mbps", (double)loop * size / time, size, align);
+		log_debug("check " << value);
+	}
+
+	/**
+	 * distinct object key from source
+	 **/
+	std::vector<std::string>
+	__bench_keys(random::Source::Param param, size_t count)
+	{
+		auto source = random::SourceFactory::get(param);
+		std::unordered_set<std::string> exist;
+		std::vector<std::string> array;
+		Data data;
+		/** source may repeat, stop when too many */
+		for (size_t loop = 0; array.size() < count && loop < count * 4; loop++) {
+			source->get(&data);
+			std::string key(data.ptr, strnlen(data.ptr, data.len));
+			if (exist.insert(key).second) {
+				array.push_back(key);
+			}
+		}
+		return array;
+	}
+
+	/**
+	 * bucket chi-square of keys, normalized by freedom, near 1 for uniform
+	 **/
+	void
+	__bench_chi(const BenchHash& bench, const std::vector<std::string>& keys, const char* source)
+	{
+		const size_t bucket = 1 << 12;
+		std::vector<int64_t> count(bucket, 0);
+		for (auto& key : keys) {
+			count[bench.hash((const byte_t*)key.data(), key.length()) & (bucket - 1)]++;
+		}
+
+		double expect = (double)keys.size() / bucket;
+		double chi = 0;
+		int64_t most = 0;
+		for (auto value : count) {
+			chi += (value - expect) * (value - expect) / expect;
+			most = std::max(most, value);
+		}
+		__bench_output("bucket_chi", bench.name, "chi", chi / (bucket - 1), 0, -1, source);
+		__bench_output("bucket_max", bench.name, "ratio", most / expect, 0, -1, source);
+	}
+
+	void
+	hash_bench_test()
+	{
+		std::vector<byte_t> data(c_length_1M * 64 + 64);
+		for (size_t i = 0; i < data.size(); i++) {
+			data[i] = (byte_t)rand();
+		}
+		log_info("hash bench, kernel " << hash_kernel());
+		/** result start from new line */
+		printf("\n");
+
+		for (auto& bench : s_bench_hash) {
+			for (size_t size = 8; size <= 512; size <<= 1) {
+				__bench_key(bench, data, size, 0);
+				__bench_key(bench, data, size, 1);
+			}
+			for (size_t size : { c_length_4K, c_length_64K, c_length_1M, c_length_1M * 16, c_length_1M * 64 }) {
+				__bench_payload(bench, data, size, 0);
+				__bench_payload(bench, data, size, 1);
+			}
+		}
+
+		/** object key like name, random length, uuid and sequence */
+		const size_t count = 1 << 18;
+		struct {
+			const char* name;
+			std::vector<std::string> keys;
+		} source[] = {
+			{ "rand", __bench_keys(random::Source::Param(random::Source::T_rand, 10, 30, true), count) },
+		#if USING_UUID
+			{ "uuid", __bench_keys(random::Source::Param(random::Source::T_uuid, 33), count) },
+		#endif
+			{ "seqn", __bench_keys(random::Source::Param(random::Source::T_seqn, 16), count) },
+		};
+		for (auto& item : source) {
+			log_info("hash bench, source " << item.name << ", distinct key " << item.keys.size());
+			for (auto& bench : s_bench_hash) {
+				__bench_chi(bench, item.keys, item.name);
+			}
+		}
+	}
+}
+}
+#endif
@@ -1,6 +1,8 @@
 
 #include "Common/Display.hpp"
 #include "Common/Logger.hpp"
+#include "Advance/MemPool.hpp"
+#include "Advance/MemAccount.hpp"
 #include "Perform/StatThread.hpp"
 
 namespace common {
@@ -24,13 +26,19 @@ StatisticThread::output(bool summary)
 	auto time = m_timer.elapse();
 
 	if (summary) {
-		var_info("Empty: %3d total: %s size: %s, using: %s   iops: %s throughput: %s  error: %s", empty_total(),
+		var_info("Empty: %3d total: %s size: %s, using: %s   iops: %s throughput: %s  error: %s  reclaim: %s", empty_total(),
 			string_count(iops_total).c_str(),
 			string_size(size_total).c_str(),
 			string_elapse(time).c_str(),
 			string_iops(iops_total, time).c_str(),
 			string_speed(size_total, time).c_str(),
-			string_count(m_statis.warn.total()).c_str());
+			string_count(m_statis.warn.total()).c_str(),
+			string_size(mem_reclaimed()).c_str());
+
+		std::string account = account_summary();
+		if (!account.empty()) {
+			log_info(account);
+		}
 
 	} else {
 		var_info("%s iops: %6s,  lan: %9s,  output: %10s"
@@ -45,6 +53,11 @@ StatisticThread::output(bool summary)
 			string_iops(iops_total, time).c_str(),
 			string_speed(size_total, time).c_str(),
 			string_percent(iops_total, m_statis.total).c_str());
+
+		std::string account = account_display(wait);
+		if (!account.empty()) {
+			log_info(account);
+		}
 	}
 }
 
@@ -85,6 +98,9 @@ StatisticThread::active(int64_t iops)
 void*
 StatisticThread::entry()
 {
+	if (cpu() >= 0) {
+		log_info("statistic thread, bind cpu " << cpu() << ", node " << topology().node(cpu()));
+	}
 	while (waiting()) {
 
 		if (get_bit(T_record)) {
@@ -161,6 +177,7 @@ StatisticThread::regist()
 	add("iops: %5s, ", string_iops, iops_total, time);
 	add("speed: %s ", string_speed, size_total, time);
 	add("[%s]", string_percent, iops_total, m_statis.total);
+	add("  %s", account_display, last);
 
 	sum("Empty: %s ", format_simple, "%3d", BIND_THIS(empty_total));
 	sum("total: %s ", string_count, iops_total, true);
@@ -168,7 +185,9 @@ StatisticThread::regist()
 	sum("using: %s   ", string_elapse, time);
 	sum("iops: %s ", string_iops, iops_total, time);
 	sum("throughput: %s  ", string_speed, size_total, time);
-	sum("error: %s", string_count, BIND(&m_statis.warn, total), true);
+	sum("error: %s  ", string_count, BIND(&m_statis.warn, total), true);
+	sum("reclaim: %s", string_size, std::bind(mem_reclaimed), true);
+	sum("  %s", account_summary);
 
 #if 0
 {
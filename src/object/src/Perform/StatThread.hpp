@@ -2,6 +2,7 @@
 #pragma once
 
 #include "Common/ThreadBase.hpp"
+#include "Common/Topology.hpp"
 #include "CodeHelper/Bitset.hpp"
 #include "Advance/Functional.hpp"
 #include "Perform/Statistic.hpp"
@@ -93,6 +94,11 @@ namespace tester {
 		 **/
 		void	output_empty(bool set) { set_bit(T_empty, set); }
 
+		/**
+		 * set thread placement, take effect when start
+		 **/
+		void	placement(const Placement& place) { set_cpu(place.cpu(0)); }
+
 		/**
 		 * get statistic
 		 **/